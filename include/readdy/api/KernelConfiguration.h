@@ -51,6 +51,67 @@ struct NeighborList {
      * drastically increase memory requirements.
      */
     std::uint8_t cll_radius {1};
+    /**
+     * Whether to use Verlet lists, which are only rebuilt once a particle moved further than half of the skin size.
+     * This only pays off with a nonzero skin.
+     */
+    bool verlet {false};
+    /**
+     * Reorder the particle data along a Hilbert curve before every n-th full rebuild of the neighbor list, which
+     * keeps particles that are close in space close in memory. A value of 0 disables the periodic reordering.
+     */
+    std::uint32_t hilbert_sort_interval {0};
+    /**
+     * Additionally reorder the particle data if, at the previous rebuild, more than this fraction of particles were
+     * contained in a different cell than their predecessor in memory. Values >= 1 disable this heuristic. Right after
+     * reordering, this fraction is about the inverse of the mean number of particles per cell, so the threshold should
+     * be well above that.
+     */
+    double hilbert_sort_threshold {1};
+    /**
+     * Remove deactivated particle slots from the particle data before a full rebuild of the neighbor list if they
+     * make up more than this fraction of it. Values >= 1 disable compaction.
+     */
+    double compaction_threshold {1};
+    /**
+     * Whether to reorder the particle data by cell at each full rebuild of the neighbor list, so that the particles of
+     * a cell are contiguous in memory.
+     */
+    bool sort_by_cell {false};
+    /**
+     * If positive and smaller than the maximal cutoff, the cells are sized for this cutoff. Particle types that
+     * interact over larger distances are searched over correspondingly more cells. This pays off for systems of few
+     * large and many small particles. A value of 0 sizes the cells by the maximal cutoff.
+     */
+    double small_cutoff {0};
+    /**
+     * Whether to collect the particle pairs within the maximal cutoff into a list once per neighbor list update, which
+     * is then shared by the force calculation and the reaction handlers instead of traversing the cells each time.
+     */
+    bool pair_list {false};
+    /**
+     * Whether to only materialize the cells that contain particles instead of the full grid spanning the box, so that
+     * memory and setup time scale with the number of particles rather than the volume. This pays off for dilute
+     * systems in large boxes. Multi-resolution cells (see small_cutoff) are not used in this mode.
+     */
+    bool sparse_cells {false};
+    /**
+     * Lower bound of the skin of the neighbor list, the larger one of this and the skin requested by the simulation
+     * scheme is used. This is where the auto-tuner stores its choice.
+     */
+    double skin {0};
+    /**
+     * If enabled, Simulation::run times a few trial steps for several combinations of cll_radius, skin, and Verlet
+     * lists before the simulation starts. The fastest combination is stored in this configuration and auto_tune is
+     * disabled again, so that the result can be persisted with the configuration. The particles are put back after
+     * the trial steps, but the steps draw from the random number generators of the threads, so the following
+     * simulation does not see the same random numbers as it would without tuning.
+     */
+    bool auto_tune {false};
+    /**
+     * The number of trial steps per combination, see auto_tune.
+     */
+    std::uint32_t auto_tune_steps {10};
 };
 /**
  * Json serialization of NeighborList config struct
@@ -97,6 +158,37 @@ void to_json(json &j, const ThreadConfig &nl);
  */
 void from_json(const json &j, ThreadConfig &nl);
 
+/**
+ * Struct with configuration attributes for the particle data of the CPU kernel
+ */
+struct ParticleData {
+    /**
+     * Whether to maintain a hash map from particle ids to their indices in the particle data. It makes lookups by id
+     * (e.g., Simulation::getParticlesForIds) take constant time per particle, but has to be updated whenever
+     * particles are added, removed, or reordered. Without it, lookups scan the particle data once.
+     */
+    bool index_ids {false};
+    /**
+     * Ids of newly created particles (e.g., reaction products) are reserved from the global id counter in blocks of
+     * this size, so that only the reservation of a block is an atomic operation. Ids remaining in a block when the
+     * kernel is reconfigured are skipped. With a value of 1, every id is taken from the global counter directly and
+     * the ids are consecutive in the order of their creation.
+     */
+    std::uint32_t id_block_size {1024};
+};
+/**
+ * Json serialization of ParticleData config struct
+ * @param j the json object
+ * @param pd the configurational object
+ */
+void to_json(json &j, const ParticleData &pd);
+/**
+ * Json deserialization to ParticleData config struct
+ * @param j the json object
+ * @param pd the configurational object
+ */
+void from_json(const json &j, ParticleData &pd);
+
 /**
  * Struct that contains configuration information for the CPU kernel.
  */
@@ -109,6 +201,10 @@ struct Configuration {
      * Configuration of the threading behavior
      */
     ThreadConfig threadConfig {};
+    /**
+     * Configuration of the particle data
+     */
+    ParticleData particleData {};
 };
 /**
  * Json serialization of ThreadConfig
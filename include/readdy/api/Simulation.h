@@ -158,6 +158,13 @@ public:
      */
     std::vector<model::Particle> getParticlesForTopology(const model::top::GraphTopology &topology) const;
 
+    /**
+     * Method yielding the particles with the given ids, in the same order as the ids.
+     * @param ids the ids of currently existing particles
+     * @return a vector of particles
+     */
+    std::vector<model::Particle> getParticlesForIds(const std::vector<model::Particle::id_type> &ids) const;
+
     /**
      * Method to set the box size.
      * @param dx length of the x-axis
@@ -419,6 +426,14 @@ public:
      */
     void addParticle(const std::string &type, scalar x, scalar y, scalar z);
 
+    /**
+     * A method to add several particles of a previously registered type to the system at once. Particles whose
+     * position is not within the simulation box are skipped.
+     * @param type the type of the particles
+     * @param positions the positions of the particles
+     */
+    void addParticles(const std::string &type, const std::vector<Vec3> &positions);
+
     /**
      * Method that gives access to all the positions of all the particles in the system.
      * @return a vector containing all the positions
@@ -224,6 +224,67 @@ distSquared(const Vec3 &lhs, const Vec3 &rhs, const scalar dx, const scalar dy,
     return dv * dv;
 }
 
+/**
+ * Tag type bundling the operations for one combination of periodic axes. Loops that are templated on it have the
+ * boundary conditions resolved at compile time, see dispatchPeriodicBoundaries.
+ */
+template<bool PX, bool PY, bool PZ>
+struct PeriodicBoundaries {
+    static constexpr bool x = PX;
+    static constexpr bool y = PY;
+    static constexpr bool z = PZ;
+
+    template<typename Container>
+    static Vec3 shortestDifference(const Vec3 &lhs, const Vec3 &rhs, const Container &box) {
+        return bcs::shortestDifference<PX, PY, PZ>(lhs, rhs, box[0], box[1], box[2]);
+    }
+
+    template<typename Container>
+    static scalar distSquared(const Vec3 &lhs, const Vec3 &rhs, const Container &box) {
+        return bcs::distSquared<PX, PY, PZ>(lhs, rhs, box[0], box[1], box[2]);
+    }
+
+    template<typename Container>
+    static void fixPosition(Vec3 &vec, const Container &box) {
+        bcs::fixPosition<PX, PY, PZ>(vec, box[0], box[1], box[2]);
+    }
+
+    template<typename Container>
+    static Vec3 applyPBC(const Vec3 &in, const Container &box) {
+        return bcs::applyPBC<PX, PY, PZ>(in, box[0], box[1], box[2]);
+    }
+};
+
+template<bool PX, bool PY, bool PZ> constexpr bool PeriodicBoundaries<PX, PY, PZ>::x;
+template<bool PX, bool PY, bool PZ> constexpr bool PeriodicBoundaries<PX, PY, PZ>::y;
+template<bool PX, bool PY, bool PZ> constexpr bool PeriodicBoundaries<PX, PY, PZ>::z;
+
+/**
+ * Invokes a (generic) function with the PeriodicBoundaries tag that matches the given periodicity, so that the
+ * function is instantiated once per combination of periodic axes and the choice is made only once per call.
+ * @param periodic the periodicity per axis
+ * @param function the function, taking the tag as argument
+ * @return the function's result
+ */
+template<typename Container, typename Function>
+inline auto dispatchPeriodicBoundaries(const Container &periodic, Function &&function)
+-> decltype(function(PeriodicBoundaries<false, false, false>{})) {
+    if (periodic[0]) {
+        if (periodic[1]) {
+            if (periodic[2]) return function(PeriodicBoundaries<true, true, true>{});
+            return function(PeriodicBoundaries<true, true, false>{});
+        }
+        if (periodic[2]) return function(PeriodicBoundaries<true, false, true>{});
+        return function(PeriodicBoundaries<true, false, false>{});
+    }
+    if (periodic[1]) {
+        if (periodic[2]) return function(PeriodicBoundaries<false, true, true>{});
+        return function(PeriodicBoundaries<false, true, false>{});
+    }
+    if (periodic[2]) return function(PeriodicBoundaries<false, false, true>{});
+    return function(PeriodicBoundaries<false, false, false>{});
+}
+
 
 NAMESPACE_END(bcs)
 NAMESPACE_END(readdy)
\ No newline at end of file
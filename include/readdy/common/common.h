@@ -44,7 +44,14 @@ NAMESPACE_BEGIN(readdy)
 
 constexpr inline std::size_t operator "" _z ( unsigned long long n ) { return n; }
 
+#ifdef READDY_SINGLE_PRECISION
+// positions, forces, and potential parameters
+using scalar = float;
+#else
 using scalar = double;
+#endif
+// sums over many contributions, e.g., total energies and virials
+using accumulator_type = double;
 using stride_type = std::uint32_t;
 using Vec3 = _internal::ReaDDyVec3<scalar>;
 using Matrix33 = _internal::ReaDDyMatrix33<scalar>;
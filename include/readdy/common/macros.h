@@ -54,6 +54,16 @@
 #  define READDY_API __attribute__ ((visibility("default")))
 #endif
 
+/**
+ * Compile a function for several instruction sets and let the loader pick the best one for the executing CPU. Only
+ * available on x86_64 linux with gcc, elsewhere the function is just compiled for the configured target.
+ */
+#if READDY_LINUX && defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 6
+#  define READDY_TARGET_CLONES __attribute__ ((target_clones("avx512f", "avx2", "default")))
+#else
+#  define READDY_TARGET_CLONES
+#endif
+
 #if !defined(NAMESPACE_BEGIN)
 #  define NAMESPACE_BEGIN(name) namespace name {
 #endif
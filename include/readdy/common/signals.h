@@ -270,8 +270,9 @@ public:
      * @param args arguments for the slots
      */
     void fire_signal(Args... args) {
+        // every slot gets its own copy of the arguments, forwarding would let the first slot move them away
         for(auto &slot : *this) {
-            slot(std::forward<Args>(args)...);
+            slot(args...);
         }
     }
 
@@ -71,7 +71,7 @@ public:
                 auto desiredWidth = static_cast<scalar>((_max_cutoff + _skin) / static_cast<scalar>(radius));
                 std::array<std::size_t, 3> dims{};
                 for (int i = 0; i < 3; ++i) {
-                    dims[i] = static_cast<unsigned int>(std::max(1., std::floor(size[i] / desiredWidth)));
+                    dims[i] = static_cast<unsigned int>(std::max(c_::one, std::floor(size[i] / desiredWidth)));
                     _cellSize[i] = size[i] / static_cast<scalar>(dims[i]);
                 }
 
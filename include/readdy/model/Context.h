@@ -120,6 +120,14 @@ public:
 
     const scalar calculateMaxCutoff() const;
 
+    /**
+     * The largest distance over which particles of each pair of types interact, i.e., the maximum over the cutoffs of
+     * the pair potentials, the educt distances of bimolecular reactions, and the radii of spatial topology reactions
+     * between the two types. Pairs without any such interaction are not contained.
+     * @return map from particle type pair to its maximal cutoff
+     */
+    const util::particle_type_pair_unordered_map<scalar> calculateMaxCutoffs() const;
+
     compartments::CompartmentRegistry &compartments() {
         return _compartmentRegistry;
     }
@@ -186,6 +186,14 @@ public:
 
     virtual void finalize() {};
 
+    /**
+     * Called by Simulation::run before the simulation loop, so that the kernel can adapt its configuration to the
+     * system at hand. Does nothing by default.
+     * @param timeStep the time step of the upcoming simulation
+     * @param node perf node
+     */
+    virtual void tune(scalar timeStep, const util::PerformanceNode &node) {};
+
     bool singlePrecision() const noexcept {
         return readdy::single_precision;
     }
@@ -99,6 +99,15 @@ public:
         return std::atomic_fetch_add<id_type>(&id_counter, 1);
     }
 
+    /**
+     * Reserves a contiguous block of ids at once.
+     * @param n the number of ids
+     * @return the first id of the block, the block ranges up to (excluding) the returned id plus n
+     */
+    static id_type nextIds(std::size_t n) {
+        return std::atomic_fetch_add<id_type>(&id_counter, static_cast<id_type>(n));
+    }
+
 protected:
     Vec3 pos;
     type_type type;
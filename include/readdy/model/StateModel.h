@@ -73,10 +73,25 @@ public:
 
     virtual void addParticles(const std::vector<Particle> &p) = 0;
 
+    /**
+     * Adds particles of one type, their ids are taken as one contiguous block.
+     * @param type the type of the particles
+     * @param positions the positions of the particles
+     */
+    virtual void addParticles(particle_type_type type, const std::vector<Vec3> &positions);
+
     virtual readdy::model::top::GraphTopology *const addTopology(topology_type_type type, const std::vector<TopologyParticle> &particles) = 0;
 
     virtual std::vector<Particle> getParticlesForTopology(const top::GraphTopology &topology) const;
 
+    /**
+     * Looks up several particles by their ids at once.
+     * @param ids the ids of currently existing particles
+     * @return the particles in the same order as the ids
+     * @throws std::out_of_range if one of the ids does not belong to an existing particle
+     */
+    virtual std::vector<Particle> getParticlesForIds(const std::vector<Particle::id_type> &ids) const;
+
     virtual std::vector<top::GraphTopology*> getTopologies() = 0;
 
     virtual top::GraphTopology const* getTopologyForParticle(top::Topology::particle_index particle) const = 0;
@@ -0,0 +1,354 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * This file is part of ReaDDy.                                     *
+ *                                                                  *
+ * ReaDDy is free software: you can redistribute it and/or modify   *
+ * it under the terms of the GNU Lesser General Public License as   *
+ * published by the Free Software Foundation, either version 3 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU Lesser General Public License for more details.              *
+ *                                                                  *
+ * You should have received a copy of the GNU Lesser General        *
+ * Public License along with this program. If not, see              *
+ * <http://www.gnu.org/licenses/>.                                  *
+ ********************************************************************/
+
+
+/**
+ * Flat representation of the first order potentials. The potentials registered in the PotentialRegistry are compiled
+ * into a table of POD descriptors indexed by particle type when the context is configured. The kernels evaluate one
+ * potential for a whole batch of particles given in structure-of-arrays layout, so that kernels can bucket particles
+ * by type and apply each potential in a single loop without hashing and without virtual calls.
+ *
+ * @file ExternalPotentialTable.h
+ * @brief Per-type table of POD first order potential descriptors and the corresponding batched kernels.
+ * @author clonker
+ * @date 08.02.18
+ * @copyright GNU Lesser General Public License v3.0
+ */
+
+#pragma once
+
+#include <typeinfo>
+#include <unordered_map>
+#include "PotentialsOrder1.h"
+
+NAMESPACE_BEGIN(readdy)
+NAMESPACE_BEGIN(model)
+NAMESPACE_BEGIN(potentials)
+
+/**
+ * strongly typed enum holding the kinds of first order potentials that have a flat representation
+ */
+enum class ExternalPotentialKind : std::uint8_t {
+    BOX, /**< Box */
+    SPHERE_IN, /**< SphereIn */
+    SPHERE_OUT, /**< SphereOut */
+    SPHERICAL_BARRIER, /**< SphericalBarrier */
+    USER_DEFINED /**< any other potential, evaluated through its virtual interface */
+};
+
+struct BoxParameters {
+    scalar forceConstant;
+    scalar min[3];
+    scalar max[3];
+};
+
+struct SphereParameters {
+    scalar forceConstant;
+    scalar origin[3];
+    scalar radius;
+};
+
+struct SphericalBarrierParameters {
+    scalar origin[3];
+    scalar radius;
+    scalar height;
+    scalar width;
+    scalar r1, r2, r3, r4;
+    scalar effectiveForceConstant;
+};
+
+/**
+ * POD descriptor of a single first order potential
+ */
+struct ExternalPotentialDescriptor {
+    ExternalPotentialKind kind;
+    union {
+        BoxParameters box;
+        SphereParameters sphere;
+        SphericalBarrierParameters sphericalBarrier;
+        const PotentialOrder1 *userDefined;
+    };
+};
+
+/**
+ * Kernels evaluating forces and energies of one potential kind for n particles. The positions are given as x/y/z
+ * lanes, the forces and energies are added to the fx/fy/fz and energy lanes. The loops are free of branches (except
+ * for user defined potentials), so that they can be vectorized.
+ */
+template<ExternalPotentialKind kind>
+struct ExternalKernel;
+
+template<>
+struct ExternalKernel<ExternalPotentialKind::BOX> {
+    static void forcesAndEnergies(const ExternalPotentialDescriptor &descriptor, std::size_t n,
+                                  const scalar *__restrict x, const scalar *__restrict y, const scalar *__restrict z,
+                                  scalar *__restrict fx, scalar *__restrict fy, scalar *__restrict fz,
+                                  scalar *__restrict energy) {
+        const auto k = descriptor.box.forceConstant;
+        const auto minX = descriptor.box.min[0], minY = descriptor.box.min[1], minZ = descriptor.box.min[2];
+        const auto maxX = descriptor.box.max[0], maxY = descriptor.box.max[1], maxZ = descriptor.box.max[2];
+        for (std::size_t i = 0; i < n; ++i) {
+            // deviation from the closest point inside of the box, zero if inside
+            const auto dx = x[i] < minX ? x[i] - minX : (x[i] > maxX ? x[i] - maxX : c_::zero);
+            const auto dy = y[i] < minY ? y[i] - minY : (y[i] > maxY ? y[i] - maxY : c_::zero);
+            const auto dz = z[i] < minZ ? z[i] - minZ : (z[i] > maxZ ? z[i] - maxZ : c_::zero);
+            energy[i] += c_::half * k * (dx * dx + dy * dy + dz * dz);
+            fx[i] -= k * dx;
+            fy[i] -= k * dy;
+            fz[i] -= k * dz;
+        }
+    }
+};
+
+template<>
+struct ExternalKernel<ExternalPotentialKind::SPHERE_IN> {
+    static void forcesAndEnergies(const ExternalPotentialDescriptor &descriptor, std::size_t n,
+                                  const scalar *__restrict x, const scalar *__restrict y, const scalar *__restrict z,
+                                  scalar *__restrict fx, scalar *__restrict fy, scalar *__restrict fz,
+                                  scalar *__restrict energy) {
+        const auto k = descriptor.sphere.forceConstant;
+        const auto radius = descriptor.sphere.radius;
+        const auto ox = descriptor.sphere.origin[0], oy = descriptor.sphere.origin[1], oz = descriptor.sphere.origin[2];
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto dx = x[i] - ox;
+            const auto dy = y[i] - oy;
+            const auto dz = z[i] - oz;
+            const auto distanceFromOrigin = std::sqrt(dx * dx + dy * dy + dz * dz);
+            const auto distanceFromSphere = distanceFromOrigin - radius;
+            // particles outside of the sphere are pushed back in
+            const auto outside = distanceFromSphere > 0;
+            energy[i] += outside ? c_::half * k * distanceFromSphere * distanceFromSphere : c_::zero;
+            const auto factor = outside ? -k * distanceFromSphere / distanceFromOrigin : c_::zero;
+            fx[i] += factor * dx;
+            fy[i] += factor * dy;
+            fz[i] += factor * dz;
+        }
+    }
+};
+
+template<>
+struct ExternalKernel<ExternalPotentialKind::SPHERE_OUT> {
+    static void forcesAndEnergies(const ExternalPotentialDescriptor &descriptor, std::size_t n,
+                                  const scalar *__restrict x, const scalar *__restrict y, const scalar *__restrict z,
+                                  scalar *__restrict fx, scalar *__restrict fy, scalar *__restrict fz,
+                                  scalar *__restrict energy) {
+        const auto k = descriptor.sphere.forceConstant;
+        const auto radius = descriptor.sphere.radius;
+        const auto ox = descriptor.sphere.origin[0], oy = descriptor.sphere.origin[1], oz = descriptor.sphere.origin[2];
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto dx = x[i] - ox;
+            const auto dy = y[i] - oy;
+            const auto dz = z[i] - oz;
+            const auto distanceFromOrigin = std::sqrt(dx * dx + dy * dy + dz * dz);
+            const auto distanceFromSphere = distanceFromOrigin - radius;
+            // particles inside of the sphere are pushed out
+            const auto inside = distanceFromSphere < 0;
+            energy[i] += inside ? c_::half * k * distanceFromSphere * distanceFromSphere : c_::zero;
+            const auto factor = inside ? -k * distanceFromSphere / distanceFromOrigin : c_::zero;
+            fx[i] += factor * dx;
+            fy[i] += factor * dy;
+            fz[i] += factor * dz;
+        }
+    }
+};
+
+template<>
+struct ExternalKernel<ExternalPotentialKind::SPHERICAL_BARRIER> {
+    static void forcesAndEnergies(const ExternalPotentialDescriptor &descriptor, std::size_t n,
+                                  const scalar *__restrict x, const scalar *__restrict y, const scalar *__restrict z,
+                                  scalar *__restrict fx, scalar *__restrict fy, scalar *__restrict fz,
+                                  scalar *__restrict energy) {
+        const auto &p = descriptor.sphericalBarrier;
+        const auto ox = p.origin[0], oy = p.origin[1], oz = p.origin[2];
+        const auto radius = p.radius, width = p.width, height = p.height, k = p.effectiveForceConstant;
+        const auto r1 = p.r1, r2 = p.r2, r3 = p.r3, r4 = p.r4;
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto dx = x[i] - ox;
+            const auto dy = y[i] - oy;
+            const auto dz = z[i] - oz;
+            const auto distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+            // the barrier consists of three harmonic snippets on [r1, r2), [r2, r3), and [r3, r4)
+            const auto dr = distance - radius + (distance < r2 ? width : (distance >= r3 ? -width : c_::zero));
+            const auto harmonic = c_::half * k * dr * dr;
+            const auto flank = distance < r2 || distance >= r3;
+            const auto active = distance >= r1 && distance < r4;
+            energy[i] += active ? (flank ? harmonic : height - harmonic) : c_::zero;
+            const auto factor = active ? (flank ? -k : k) * dr / distance : c_::zero;
+            fx[i] += factor * dx;
+            fy[i] += factor * dy;
+            fz[i] += factor * dz;
+        }
+    }
+};
+
+template<>
+struct ExternalKernel<ExternalPotentialKind::USER_DEFINED> {
+    static void forcesAndEnergies(const ExternalPotentialDescriptor &descriptor, std::size_t n,
+                                  const scalar *__restrict x, const scalar *__restrict y, const scalar *__restrict z,
+                                  scalar *__restrict fx, scalar *__restrict fy, scalar *__restrict fz,
+                                  scalar *__restrict energy) {
+        for (std::size_t i = 0; i < n; ++i) {
+            Vec3 force{0, 0, 0};
+            descriptor.userDefined->calculateForceAndEnergy(force, energy[i], {x[i], y[i], z[i]});
+            fx[i] += force.x;
+            fy[i] += force.y;
+            fz[i] += force.z;
+        }
+    }
+};
+
+/**
+ * Dispatches to the kernel of the descriptor's kind, i.e., the dispatch happens once per batch of particles.
+ */
+inline void calculateForcesAndEnergies(const ExternalPotentialDescriptor &descriptor, std::size_t n,
+                                       const scalar *x, const scalar *y, const scalar *z,
+                                       scalar *fx, scalar *fy, scalar *fz, scalar *energy) {
+    switch (descriptor.kind) {
+        case ExternalPotentialKind::BOX:
+            return ExternalKernel<ExternalPotentialKind::BOX>::forcesAndEnergies(descriptor, n, x, y, z,
+                                                                                 fx, fy, fz, energy);
+        case ExternalPotentialKind::SPHERE_IN:
+            return ExternalKernel<ExternalPotentialKind::SPHERE_IN>::forcesAndEnergies(descriptor, n, x, y, z,
+                                                                                       fx, fy, fz, energy);
+        case ExternalPotentialKind::SPHERE_OUT:
+            return ExternalKernel<ExternalPotentialKind::SPHERE_OUT>::forcesAndEnergies(descriptor, n, x, y, z,
+                                                                                        fx, fy, fz, energy);
+        case ExternalPotentialKind::SPHERICAL_BARRIER:
+            return ExternalKernel<ExternalPotentialKind::SPHERICAL_BARRIER>::forcesAndEnergies(descriptor, n, x, y, z,
+                                                                                               fx, fy, fz, energy);
+        case ExternalPotentialKind::USER_DEFINED:
+            return ExternalKernel<ExternalPotentialKind::USER_DEFINED>::forcesAndEnergies(descriptor, n, x, y, z,
+                                                                                          fx, fy, fz, energy);
+    }
+}
+
+/**
+ * Table mapping each particle type to the descriptors of its first order potentials.
+ */
+class ExternalPotentialTable {
+public:
+    using descriptor_type = ExternalPotentialDescriptor;
+    using const_iterator = const descriptor_type *;
+    using potential_o1_registry = std::unordered_map<particle_type_type, std::vector<PotentialOrder1 *>>;
+
+    /**
+     * (Re)builds the table from a registry of first order potentials
+     * @param registry the registry
+     */
+    void build(const potential_o1_registry &registry) {
+        _nTypes = 0;
+        for (const auto &entry : registry) {
+            if (!entry.second.empty()) {
+                _nTypes = std::max(_nTypes, static_cast<std::size_t>(entry.first) + 1);
+            }
+        }
+        _offsets.assign(_nTypes + 1, 0);
+        _descriptors.clear();
+        for (std::size_t t = 0; t < _nTypes; ++t) {
+            auto it = registry.find(static_cast<particle_type_type>(t));
+            if (it != registry.end()) {
+                for (const auto potential : it->second) {
+                    _descriptors.push_back(describe(*potential));
+                }
+            }
+            _offsets[t + 1] = _descriptors.size();
+        }
+    }
+
+    const_iterator begin(particle_type_type type) const {
+        return type < _nTypes ? _descriptors.data() + _offsets[type] : nullptr;
+    }
+
+    const_iterator end(particle_type_type type) const {
+        return type < _nTypes ? _descriptors.data() + _offsets[type + 1] : nullptr;
+    }
+
+    bool empty() const {
+        return _descriptors.empty();
+    }
+
+    /**
+     * @return one plus the largest type that has first order potentials
+     */
+    std::size_t nTypes() const {
+        return _nTypes;
+    }
+
+    static descriptor_type describe(const PotentialOrder1 &potential);
+
+private:
+    template<typename Sphere>
+    static void describeSphere(const Sphere &potential, SphereParameters &parameters) {
+        parameters.forceConstant = potential.forceConstant;
+        for (int d = 0; d < 3; ++d) {
+            parameters.origin[d] = potential.origin[d];
+        }
+        parameters.radius = potential.radius;
+    }
+
+    std::size_t _nTypes{0};
+    // offsets into _descriptors of size (n_types + 1)
+    std::vector<std::size_t> _offsets{0};
+    std::vector<descriptor_type> _descriptors;
+};
+
+inline ExternalPotentialTable::descriptor_type ExternalPotentialTable::describe(const PotentialOrder1 &potential) {
+    descriptor_type result{};
+    // exact type matches only, subclasses might override the evaluation
+    const auto &type = typeid(potential);
+    if (type == typeid(Box)) {
+        const auto &pot = static_cast<const Box &>(potential);
+        result.kind = ExternalPotentialKind::BOX;
+        result.box.forceConstant = pot.forceConstant;
+        for (int d = 0; d < 3; ++d) {
+            result.box.min[d] = pot.min[d];
+            result.box.max[d] = pot.max[d];
+        }
+    } else if (type == typeid(SphereIn)) {
+        result.kind = ExternalPotentialKind::SPHERE_IN;
+        describeSphere(static_cast<const SphereIn &>(potential), result.sphere);
+    } else if (type == typeid(SphereOut)) {
+        result.kind = ExternalPotentialKind::SPHERE_OUT;
+        describeSphere(static_cast<const SphereOut &>(potential), result.sphere);
+    } else if (type == typeid(SphericalBarrier)) {
+        const auto &pot = static_cast<const SphericalBarrier &>(potential);
+        result.kind = ExternalPotentialKind::SPHERICAL_BARRIER;
+        for (int d = 0; d < 3; ++d) {
+            result.sphericalBarrier.origin[d] = pot.origin[d];
+        }
+        result.sphericalBarrier.radius = pot.radius;
+        result.sphericalBarrier.height = pot.height;
+        result.sphericalBarrier.width = pot.width;
+        result.sphericalBarrier.r1 = pot.r1;
+        result.sphericalBarrier.r2 = pot.r2;
+        result.sphericalBarrier.r3 = pot.r3;
+        result.sphericalBarrier.r4 = pot.r4;
+        result.sphericalBarrier.effectiveForceConstant = pot.effectiveForceConstant;
+    } else {
+        result.kind = ExternalPotentialKind::USER_DEFINED;
+        result.userDefined = &potential;
+    }
+    return result;
+}
+
+NAMESPACE_END(potentials)
+NAMESPACE_END(model)
+NAMESPACE_END(readdy)
@@ -0,0 +1,354 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * This file is part of ReaDDy.                                     *
+ *                                                                  *
+ * ReaDDy is free software: you can redistribute it and/or modify   *
+ * it under the terms of the GNU Lesser General Public License as   *
+ * published by the Free Software Foundation, either version 3 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU Lesser General Public License for more details.              *
+ *                                                                  *
+ * You should have received a copy of the GNU Lesser General        *
+ * Public License along with this program. If not, see              *
+ * <http://www.gnu.org/licenses/>.                                  *
+ ********************************************************************/
+
+
+/**
+ * Flat representation of the second order potentials. The potentials registered in the PotentialRegistry are compiled
+ * into a dense (n_types x n_types) table of POD descriptors when the context is configured, so that kernels can
+ * evaluate pair interactions without hashing and without virtual calls.
+ *
+ * @file PairPotentialTable.h
+ * @brief Dense type-pair table of POD second order potential descriptors and the corresponding kernels.
+ * @author clonker
+ * @date 05.02.18
+ * @copyright GNU Lesser General Public License v3.0
+ */
+
+#pragma once
+
+#include <typeinfo>
+#include <readdy/common/ParticleTypeTuple.h>
+#include "PotentialsOrder2.h"
+
+NAMESPACE_BEGIN(readdy)
+NAMESPACE_BEGIN(model)
+NAMESPACE_BEGIN(potentials)
+
+/**
+ * strongly typed enum holding the kinds of second order potentials that have a flat representation
+ */
+enum class PairPotentialKind : std::uint8_t {
+    HARMONIC_REPULSION, /**< HarmonicRepulsion */
+    WEAK_INTERACTION_PIECEWISE_HARMONIC, /**< WeakInteractionPiecewiseHarmonic */
+    LENNARD_JONES, /**< LennardJones */
+    SCREENED_ELECTROSTATICS, /**< ScreenedElectrostatics */
+    TABULATED, /**< TabulatedPotential */
+    USER_DEFINED /**< any other potential, evaluated through its virtual interface */
+};
+
+struct HarmonicRepulsionParameters {
+    scalar forceConstant;
+    scalar interactionDistance;
+};
+
+struct WeakInteractionPiecewiseHarmonicParameters {
+    scalar forceConstant;
+    scalar desiredParticleDistance;
+    scalar depthAtDesiredDistance;
+    scalar noInteractionDistance;
+    // (1 / (.5 * (noInteractionDistance - desiredParticleDistance)))^2
+    scalar attractiveCurvature;
+};
+
+struct LennardJonesParameters {
+    scalar k;
+    scalar m;
+    scalar n;
+    scalar sigma;
+    // energy at the cutoff if the potential is shifted, zero otherwise
+    scalar energyShift;
+};
+
+struct ScreenedElectrostaticsParameters {
+    scalar electrostaticStrength;
+    scalar inverseScreeningDepth;
+    scalar repulsionStrength;
+    scalar repulsionDistance;
+    scalar exponent;
+};
+
+/**
+ * POD descriptor of a single second order potential
+ */
+struct PairPotentialDescriptor {
+    PairPotentialKind kind;
+    scalar cutoffSquared;
+    union {
+        HarmonicRepulsionParameters harmonicRepulsion;
+        WeakInteractionPiecewiseHarmonicParameters weakInteraction;
+        LennardJonesParameters lennardJones;
+        ScreenedElectrostaticsParameters screenedElectrostatics;
+        const TabulatedPotential *tabulated;
+        const PotentialOrder2 *userDefined;
+    };
+};
+
+/**
+ * Kernels evaluating force and energy of one potential kind for a difference vector x_ij with
+ * |x_ij|^2 = distSquared < cutoffSquared. The force is the one acting on the particle i, i.e., the same convention as
+ * PotentialOrder2::calculateForceAndEnergy.
+ */
+template<PairPotentialKind kind>
+struct PairKernel;
+
+template<>
+struct PairKernel<PairPotentialKind::HARMONIC_REPULSION> {
+    static void forceAndEnergy(const PairPotentialDescriptor &descriptor, Vec3 &force, scalar &energy,
+                               const Vec3 &x_ij, scalar distSquared) {
+        const auto &p = descriptor.harmonicRepulsion;
+        if (distSquared > 0) {
+            const auto dist = std::sqrt(distSquared);
+            const auto dr = dist - p.interactionDistance;
+            energy += c_::half * p.forceConstant * dr * dr;
+            force += (p.forceConstant * dr) / dist * x_ij;
+        }
+    }
+};
+
+template<>
+struct PairKernel<PairPotentialKind::WEAK_INTERACTION_PIECEWISE_HARMONIC> {
+    static void forceAndEnergy(const PairPotentialDescriptor &descriptor, Vec3 &force, scalar &energy,
+                               const Vec3 &x_ij, scalar distSquared) {
+        const auto &p = descriptor.weakInteraction;
+        const auto dist = std::sqrt(distSquared);
+        const auto len_part2 = p.noInteractionDistance - p.desiredParticleDistance;
+        scalar factor = 0;
+        if (dist < p.desiredParticleDistance) {
+            // repulsive as we are closer than the desired distance
+            const auto dr = dist - p.desiredParticleDistance;
+            energy += c_::half * p.forceConstant * dr * dr - p.depthAtDesiredDistance;
+            factor = p.forceConstant * dr;
+        } else if (dist < p.desiredParticleDistance + c_::half * len_part2) {
+            // attractive as we are further (but not too far) apart than the desired distance
+            const auto dr = dist - p.desiredParticleDistance;
+            energy += c_::half * p.depthAtDesiredDistance * p.attractiveCurvature * dr * dr - p.depthAtDesiredDistance;
+            factor = p.depthAtDesiredDistance * p.attractiveCurvature * dr;
+        } else if (dist < p.noInteractionDistance) {
+            // if we are not too far apart but still further than in the previous case, attractive
+            const auto dr = dist - p.noInteractionDistance;
+            energy += -c_::half * p.depthAtDesiredDistance * p.attractiveCurvature * dr * dr;
+            factor = -p.depthAtDesiredDistance * p.attractiveCurvature * dr;
+        }
+        if (dist > 0 && factor != 0) {
+            force += factor * x_ij / dist;
+        }
+    }
+};
+
+template<>
+struct PairKernel<PairPotentialKind::LENNARD_JONES> {
+    static void forceAndEnergy(const PairPotentialDescriptor &descriptor, Vec3 &force, scalar &energy,
+                               const Vec3 &x_ij, scalar distSquared) {
+        const auto &p = descriptor.lennardJones;
+        const auto sigmaOverR = p.sigma / std::sqrt(distSquared);
+        const auto powM = std::pow(sigmaOverR, p.m);
+        const auto powN = std::pow(sigmaOverR, p.n);
+        energy += p.k * (powM - powN) - p.energyShift;
+        const auto sigmaOverRSquared = sigmaOverR * sigmaOverR;
+        force += -1. * p.k * (1 / (p.sigma * p.sigma)) * (p.m * powM - p.n * powN) * sigmaOverRSquared * x_ij;
+    }
+};
+
+template<>
+struct PairKernel<PairPotentialKind::SCREENED_ELECTROSTATICS> {
+    static void forceAndEnergy(const PairPotentialDescriptor &descriptor, Vec3 &force, scalar &energy,
+                               const Vec3 &x_ij, scalar distSquared) {
+        const auto &p = descriptor.screenedElectrostatics;
+        const auto distance = std::sqrt(distSquared);
+        const auto screening = p.electrostaticStrength * std::exp(-p.inverseScreeningDepth * distance);
+        const auto repulsion = std::pow(p.repulsionDistance / distance, p.exponent);
+        energy += screening / distance + p.repulsionStrength * repulsion;
+        auto forceFactor = screening * (p.inverseScreeningDepth / distance + c_::one / distSquared);
+        forceFactor += p.repulsionStrength * p.exponent / distance * repulsion;
+        force += forceFactor * (-c_::one * x_ij / distance);
+    }
+};
+
+template<>
+struct PairKernel<PairPotentialKind::TABULATED> {
+    static void forceAndEnergy(const PairPotentialDescriptor &descriptor, Vec3 &force, scalar &energy,
+                               const Vec3 &x_ij, scalar distSquared) {
+        scalar e, forceFactor;
+        descriptor.tabulated->interpolate(distSquared, e, forceFactor);
+        energy += e;
+        force += forceFactor * x_ij;
+    }
+};
+
+template<>
+struct PairKernel<PairPotentialKind::USER_DEFINED> {
+    static void forceAndEnergy(const PairPotentialDescriptor &descriptor, Vec3 &force, scalar &energy,
+                               const Vec3 &x_ij, scalar /*distSquared*/) {
+        descriptor.userDefined->calculateForceAndEnergy(force, energy, x_ij);
+    }
+};
+
+/**
+ * Dispatches to the kernel of the descriptor's kind.
+ */
+inline void calculateForceAndEnergy(const PairPotentialDescriptor &descriptor, Vec3 &force, scalar &energy,
+                                    const Vec3 &x_ij, scalar distSquared) {
+    switch (descriptor.kind) {
+        case PairPotentialKind::HARMONIC_REPULSION:
+            return PairKernel<PairPotentialKind::HARMONIC_REPULSION>::forceAndEnergy(descriptor, force, energy, x_ij,
+                                                                                     distSquared);
+        case PairPotentialKind::WEAK_INTERACTION_PIECEWISE_HARMONIC:
+            return PairKernel<PairPotentialKind::WEAK_INTERACTION_PIECEWISE_HARMONIC>::forceAndEnergy(
+                    descriptor, force, energy, x_ij, distSquared);
+        case PairPotentialKind::LENNARD_JONES:
+            return PairKernel<PairPotentialKind::LENNARD_JONES>::forceAndEnergy(descriptor, force, energy, x_ij,
+                                                                                distSquared);
+        case PairPotentialKind::SCREENED_ELECTROSTATICS:
+            return PairKernel<PairPotentialKind::SCREENED_ELECTROSTATICS>::forceAndEnergy(descriptor, force, energy,
+                                                                                          x_ij, distSquared);
+        case PairPotentialKind::TABULATED:
+            return PairKernel<PairPotentialKind::TABULATED>::forceAndEnergy(descriptor, force, energy, x_ij,
+                                                                            distSquared);
+        case PairPotentialKind::USER_DEFINED:
+            return PairKernel<PairPotentialKind::USER_DEFINED>::forceAndEnergy(descriptor, force, energy, x_ij,
+                                                                               distSquared);
+    }
+}
+
+/**
+ * Dense table mapping each (unordered) pair of particle types to the descriptors of its second order potentials.
+ */
+class PairPotentialTable {
+public:
+    using descriptor_type = PairPotentialDescriptor;
+    using const_iterator = const descriptor_type *;
+    using potential_o2_registry = util::particle_type_pair_unordered_map<std::vector<PotentialOrder2 *>>;
+
+    /**
+     * (Re)builds the table from a registry of second order potentials
+     * @param registry the registry
+     */
+    void build(const potential_o2_registry &registry) {
+        _nTypes = 0;
+        for (const auto &entry : registry) {
+            if (!entry.second.empty()) {
+                _nTypes = std::max(_nTypes, static_cast<std::size_t>(std::get<0>(entry.first)) + 1);
+                _nTypes = std::max(_nTypes, static_cast<std::size_t>(std::get<1>(entry.first)) + 1);
+            }
+        }
+        _offsets.assign(_nTypes * _nTypes + 1, 0);
+        _descriptors.clear();
+        for (std::size_t t1 = 0; t1 < _nTypes; ++t1) {
+            for (std::size_t t2 = 0; t2 < _nTypes; ++t2) {
+                auto it = registry.find(std::make_tuple(static_cast<particle_type_type>(t1),
+                                                        static_cast<particle_type_type>(t2)));
+                if (it != registry.end()) {
+                    for (const auto potential : it->second) {
+                        _descriptors.push_back(describe(*potential));
+                    }
+                }
+                _offsets[t1 * _nTypes + t2 + 1] = _descriptors.size();
+            }
+        }
+        _interacting.assign(_nTypes, false);
+        for (std::size_t t1 = 0; t1 < _nTypes; ++t1) {
+            _interacting[t1] = _offsets[t1 * _nTypes] != _offsets[(t1 + 1) * _nTypes];
+        }
+    }
+
+    const_iterator begin(particle_type_type t1, particle_type_type t2) const {
+        return t1 < _nTypes && t2 < _nTypes ? _descriptors.data() + _offsets[t1 * _nTypes + t2] : nullptr;
+    }
+
+    const_iterator end(particle_type_type t1, particle_type_type t2) const {
+        return t1 < _nTypes && t2 < _nTypes ? _descriptors.data() + _offsets[t1 * _nTypes + t2 + 1] : nullptr;
+    }
+
+    bool empty() const {
+        return _descriptors.empty();
+    }
+
+    /**
+     * Whether a type has second order potentials with any type. Pairs in which neither type interacts can be skipped.
+     * @param type the type
+     * @return true if there is at least one potential
+     */
+    bool interacts(particle_type_type type) const {
+        return type < _nTypes && _interacting[type];
+    }
+
+    std::size_t nTypes() const {
+        return _nTypes;
+    }
+
+    static descriptor_type describe(const PotentialOrder2 &potential);
+
+private:
+    std::size_t _nTypes{0};
+    // offsets into _descriptors of size (n_types * n_types + 1)
+    std::vector<std::size_t> _offsets{0};
+    std::vector<descriptor_type> _descriptors;
+    std::vector<bool> _interacting;
+};
+
+inline PairPotentialTable::descriptor_type PairPotentialTable::describe(const PotentialOrder2 &potential) {
+    descriptor_type result{};
+    result.cutoffSquared = potential.getCutoffRadiusSquared();
+    // exact type matches only, subclasses might override the evaluation
+    const auto &type = typeid(potential);
+    if (type == typeid(HarmonicRepulsion)) {
+        const auto &pot = static_cast<const HarmonicRepulsion &>(potential);
+        result.kind = PairPotentialKind::HARMONIC_REPULSION;
+        result.harmonicRepulsion.forceConstant = pot._forceConstant;
+        result.harmonicRepulsion.interactionDistance = pot._interactionDistance;
+    } else if (type == typeid(WeakInteractionPiecewiseHarmonic)) {
+        const auto &pot = static_cast<const WeakInteractionPiecewiseHarmonic &>(potential);
+        const auto halfLen = c_::half * (pot.conf.noInteractionDistance - pot.conf.desiredParticleDistance);
+        result.kind = PairPotentialKind::WEAK_INTERACTION_PIECEWISE_HARMONIC;
+        result.weakInteraction.forceConstant = pot.forceConstant;
+        result.weakInteraction.desiredParticleDistance = pot.conf.desiredParticleDistance;
+        result.weakInteraction.depthAtDesiredDistance = pot.conf.depthAtDesiredDistance;
+        result.weakInteraction.noInteractionDistance = pot.conf.noInteractionDistance;
+        result.weakInteraction.attractiveCurvature = (c_::one / halfLen) * (c_::one / halfLen);
+    } else if (type == typeid(LennardJones)) {
+        const auto &pot = static_cast<const LennardJones &>(potential);
+        result.kind = PairPotentialKind::LENNARD_JONES;
+        result.lennardJones.k = pot.k;
+        result.lennardJones.m = pot.m;
+        result.lennardJones.n = pot.n;
+        result.lennardJones.sigma = pot.sigma;
+        result.lennardJones.energyShift = pot.shift ? pot.energy(pot.cutoffDistance) : 0;
+    } else if (type == typeid(ScreenedElectrostatics)) {
+        const auto &pot = static_cast<const ScreenedElectrostatics &>(potential);
+        result.kind = PairPotentialKind::SCREENED_ELECTROSTATICS;
+        result.screenedElectrostatics.electrostaticStrength = pot.electrostaticStrength;
+        result.screenedElectrostatics.inverseScreeningDepth = pot.inverseScreeningDepth;
+        result.screenedElectrostatics.repulsionStrength = pot.repulsionStrength;
+        result.screenedElectrostatics.repulsionDistance = pot.repulsionDistance;
+        result.screenedElectrostatics.exponent = pot.exponent;
+    } else if (type == typeid(TabulatedPotential)) {
+        result.kind = PairPotentialKind::TABULATED;
+        result.tabulated = static_cast<const TabulatedPotential *>(&potential);
+    } else {
+        result.kind = PairPotentialKind::USER_DEFINED;
+        result.userDefined = &potential;
+    }
+    return result;
+}
+
+NAMESPACE_END(potentials)
+NAMESPACE_END(model)
+NAMESPACE_END(readdy)
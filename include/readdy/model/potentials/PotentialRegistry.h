@@ -43,6 +43,8 @@
 #include "PotentialOrder2.h"
 #include "PotentialsOrder2.h"
 #include "PotentialsOrder1.h"
+#include "PairPotentialTable.h"
+#include "ExternalPotentialTable.h"
 
 NAMESPACE_BEGIN(readdy)
 NAMESPACE_BEGIN(model)
@@ -195,6 +197,19 @@ public:
 
     void remove(Potential::id_type handle);
 
+    /**
+     * Requests that a second order potential is replaced by a tabulated version of itself (see TabulatedPotential)
+     * whenever the registry is configured. This applies to built-in and user-defined potentials alike, the latter
+     * are then only evaluated during configuration.
+     * @param handle the id of the potential
+     * @param nPoints the number of grid points
+     * @param interpolation the interpolation scheme
+     */
+    void tabulate(Potential::id_type handle, std::size_t nPoints = 1000,
+                  TabulatedPotential::Interpolation interpolation = TabulatedPotential::Interpolation::CUBIC) {
+        _tabulationRequests[handle] = std::make_tuple(nPoints, interpolation);
+    }
+
     const potentials_o1 &potentialsOf(const particle_type_type type) const {
         auto it = potentialO1Registry.find(type);
         return it != potentialO1Registry.end() ? it->second : defaultPotentialsO1;
@@ -204,6 +219,15 @@ public:
         return potentialO1Registry;
     }
 
+    /**
+     * Flat representation of the first order potentials indexed by particle type, only valid after configure() was
+     * called.
+     * @return the table
+     */
+    const ExternalPotentialTable &tableOrder1() const {
+        return _tableO1;
+    }
+
     const potentials_o2 &potentialsOf(const particle_type_type t1, const particle_type_type t2) const {
         auto it = potentialO2Registry.find(std::tie(t1, t2));
         return it != potentialO2Registry.end() ? it->second : defaultPotentialsO2;
@@ -218,6 +242,24 @@ public:
         return potentialO2Registry;
     }
 
+    /**
+     * Flat representation of the second order potentials, only valid after configure() was called.
+     * @return the table
+     */
+    const PairPotentialTable &tableOrder2() const {
+        return _tableO2;
+    }
+
+    /**
+     * Whether particles of a type can feel a force, i.e., whether the type has first or second order potentials or is
+     * of topology flavor (and thus may be subject to bonded potentials). Only valid after configure() was called.
+     * @param type the type
+     * @return true if particles of this type can feel a force
+     */
+    bool interacting(particle_type_type type) const {
+        return type < _interacting.size() && _interacting[type];
+    }
+
     const potentials_o1 &potentialsOf(const std::string &type) const {
         return potentialsOf(_types.get().idOf(type));
     }
@@ -239,12 +281,20 @@ private:
     potential_o1_registry potentialO1Registry{};
     potential_o2_registry potentialO2Registry{};
     o2_registry_alt _alternativeO2Registry{};
+    ExternalPotentialTable _tableO1{};
+    PairPotentialTable _tableO2{};
+    std::vector<bool> _interacting{};
 
     potential_o1_registry_internal potentialO1RegistryInternal{};
     potential_o1_registry potentialO1RegistryExternal{};
     potential_o2_registry_internal potentialO2RegistryInternal{};
     potential_o2_registry potentialO2RegistryExternal{};
 
+    using tabulation_request = std::tuple<std::size_t, TabulatedPotential::Interpolation>;
+    std::unordered_map<id_type, tabulation_request> _tabulationRequests{};
+    // tabulated versions of second order potentials, created in configure()
+    pot_ptr_vec2 _tabulatedO2{};
+
     pot_ptr_vec1_external defaultPotentialsO1{};
     pot_ptr_vec2_external defaultPotentialsO2{};
 
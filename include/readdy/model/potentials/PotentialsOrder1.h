@@ -104,6 +104,8 @@ public:
     std::string type() const override;
 
 protected:
+    friend class ExternalPotentialTable;
+
     const Vec3 origin, extent, min, max;
     const scalar forceConstant;
 };
@@ -158,6 +160,8 @@ public:
     std::string type() const override;
 
 protected:
+    friend class ExternalPotentialTable;
+
     const Vec3 origin;
     const scalar radius, forceConstant;
 };
@@ -211,6 +215,8 @@ public:
     std::string type() const override;
 
 protected:
+    friend class ExternalPotentialTable;
+
     const Vec3 origin;
     const scalar radius, forceConstant;
 };
@@ -298,6 +304,8 @@ public:
     std::string type() const override;
 
 protected:
+    friend class ExternalPotentialTable;
+
     const Vec3 origin;
     const readdy::scalar radius, height, width, r1, r2, r3, r4, effectiveForceConstant;
 };
@@ -34,12 +34,16 @@
 #pragma once
 
 #include <ostream>
+#include <vector>
+#include <functional>
 #include "PotentialOrder2.h"
 
 NAMESPACE_BEGIN(readdy)
 NAMESPACE_BEGIN(model)
 NAMESPACE_BEGIN(potentials)
 
+class PairPotentialTable;
+
 class HarmonicRepulsion : public PotentialOrder2 {
     using super = PotentialOrder2;
 public:
@@ -105,6 +109,8 @@ public:
     std::string type() const override;
 
 protected:
+    friend class PairPotentialTable;
+
     scalar _interactionDistance;
     scalar _interactionDistanceSquared;
     scalar _forceConstant;
@@ -121,6 +127,7 @@ public:
 
     private:
         friend class WeakInteractionPiecewiseHarmonic;
+        friend class PairPotentialTable;
 
         const scalar desiredParticleDistance, depthAtDesiredDistance, noInteractionDistance, noInteractionDistanceSquared;
     };
@@ -201,6 +208,8 @@ public:
     std::string type() const override;
 
 protected:
+    friend class PairPotentialTable;
+
     const Configuration conf;
     const scalar forceConstant;
 };
@@ -284,6 +293,8 @@ public:
     std::string type() const override;
 
 protected:
+    friend class PairPotentialTable;
+
     scalar energy(scalar r) const {
         return k * (std::pow(sigma / r, m) - std::pow(sigma / r, n));
     }
@@ -350,6 +361,8 @@ public:
     std::string type() const override;
 
 protected:
+    friend class PairPotentialTable;
+
     scalar electrostaticStrength;
     scalar inverseScreeningDepth;
     scalar repulsionStrength;
@@ -359,6 +372,145 @@ protected:
     scalar cutoffSquared;
 };
 
+class TabulatedPotential : public PotentialOrder2 {
+    using super = PotentialOrder2;
+public:
+    /**
+     * strongly typed enum holding the interpolation schemes between the grid points
+     */
+    enum class Interpolation {
+        LINEAR, /**< piecewise linear interpolation */
+        CUBIC /**< piecewise cubic (Catmull-Rom) interpolation */
+    };
+
+    using radial_function = std::function<scalar(scalar)>;
+
+    /**
+     * Constructs a potential that samples a radial energy curve V(r) and the corresponding radial force
+     * F(r) = -dV/dr onto a uniform grid in r^2, covering [0, cutoff^2]. Positive radial forces are repulsive.
+     *
+     * @param type1 particle type A
+     * @param type2 particle type B
+     * @param cutoff the cutoff radius
+     * @param energy the radial energy V(r)
+     * @param force the radial force F(r)
+     * @param nPoints the number of grid points, at least 2
+     * @param interpolation the interpolation scheme
+     */
+    TabulatedPotential(particle_type_type type1, particle_type_type type2, scalar cutoff,
+                       const radial_function &energy, const radial_function &force, std::size_t nPoints,
+                       Interpolation interpolation);
+
+    /**
+     * Constructs a tabulated version of an existing second order potential by sampling it along the x-axis up to its
+     * cutoff radius.
+     *
+     * @param potential the potential to sample
+     * @param nPoints the number of grid points, at least 2
+     * @param interpolation the interpolation scheme
+     */
+    TabulatedPotential(const PotentialOrder2 &potential, std::size_t nPoints, Interpolation interpolation);
+
+    TabulatedPotential(const TabulatedPotential &) = default;
+
+    TabulatedPotential &operator=(const TabulatedPotential &) = delete;
+
+    TabulatedPotential(TabulatedPotential &&) = default;
+
+    TabulatedPotential &operator=(TabulatedPotential &&) = delete;
+
+    ~TabulatedPotential() override = default;
+
+    scalar calculateEnergy(const Vec3 &x_ij) const override {
+        const auto distSquared = x_ij * x_ij;
+        scalar energy = 0, forceFactor = 0;
+        if (distSquared < cutoffSquared) {
+            interpolate(distSquared, energy, forceFactor);
+        }
+        return energy;
+    }
+
+    void calculateForce(Vec3 &force, const Vec3 &x_ij) const override {
+        const auto distSquared = x_ij * x_ij;
+        if (distSquared < cutoffSquared) {
+            scalar energy, forceFactor;
+            interpolate(distSquared, energy, forceFactor);
+            force += forceFactor * x_ij;
+        }
+    }
+
+    void calculateForceAndEnergy(Vec3 &force, scalar &energy, const Vec3 &x_ij) const override {
+        const auto distSquared = x_ij * x_ij;
+        if (distSquared < cutoffSquared) {
+            scalar e, forceFactor;
+            interpolate(distSquared, e, forceFactor);
+            energy += e;
+            force += forceFactor * x_ij;
+        }
+    }
+
+    /**
+     * Interpolates the energy and the force factor at a squared distance smaller than the squared cutoff. The force
+     * acting on particle i is forceFactor * x_ij.
+     * @param distSquared the squared distance
+     * @param energy output, the energy
+     * @param forceFactor output, the force factor
+     */
+    void interpolate(scalar distSquared, scalar &energy, scalar &forceFactor) const {
+        const auto t = distSquared * inverseSpacing;
+        auto k = static_cast<std::size_t>(t);
+        if (k >= nIntervals) k = nIntervals - 1;
+        const auto u = t - static_cast<scalar>(k);
+        // samples are stored with one ghost point on each side, sample k lives at index k+1
+        const auto *e = energies.data() + k;
+        const auto *f = forceFactors.data() + k;
+        if (interpolation == Interpolation::LINEAR) {
+            energy = e[1] + u * (e[2] - e[1]);
+            forceFactor = f[1] + u * (f[2] - f[1]);
+        } else {
+            energy = catmullRom(e, u);
+            forceFactor = catmullRom(f, u);
+        }
+    }
+
+    scalar getCutoffRadius() const override {
+        return cutoff;
+    }
+
+    scalar getCutoffRadiusSquared() const override {
+        return cutoffSquared;
+    }
+
+    scalar getMaximalForce(scalar kbt) const noexcept override {
+        return 0;
+    }
+
+    std::size_t nPoints() const {
+        return nIntervals + 1;
+    }
+
+    std::string describe() const override;
+
+    std::string type() const override;
+
+protected:
+    static scalar catmullRom(const scalar *p, scalar u) {
+        return p[1] + c_::half * u * (p[2] - p[0] + u * (c_::two * p[0] - 5 * p[1] + 4 * p[2] - p[3]
+                                                         + u * (c_::three * (p[1] - p[2]) + p[3] - p[0])));
+    }
+
+    void sample(const std::function<void(scalar, scalar &, scalar &)> &evaluate);
+
+    scalar cutoff;
+    scalar cutoffSquared;
+    std::size_t nIntervals;
+    scalar inverseSpacing;
+    Interpolation interpolation;
+    std::string source;
+    std::vector<scalar> energies;
+    std::vector<scalar> forceFactors;
+};
+
 template<typename T>
 const std::string getPotentialName(typename std::enable_if<std::is_base_of<HarmonicRepulsion, T>::value>::type * = 0) {
     return "HarmonicRepulsion";
@@ -381,6 +533,12 @@ const std::string
 getPotentialName(typename std::enable_if<std::is_base_of<ScreenedElectrostatics, T>::value>::type * = 0) {
     return "ScreenedElectrostatics";
 }
+
+template<typename T>
+const std::string
+getPotentialName(typename std::enable_if<std::is_base_of<TabulatedPotential, T>::value>::type * = 0) {
+    return "TabulatedPotential";
+}
 NAMESPACE_END(potentials)
 NAMESPACE_END(model)
 NAMESPACE_END(readdy)
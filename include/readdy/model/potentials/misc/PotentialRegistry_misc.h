@@ -90,6 +90,7 @@ inline void PotentialRegistry::remove(const Potential::id_type handle) {
                                           }
         ), entry.second.end());
     }
+    _tabulationRequests.erase(handle);
 }
 
 inline void PotentialRegistry::configure() {
@@ -102,27 +103,50 @@ inline void PotentialRegistry::configure() {
     potentialO1Registry.clear();
     potentialO2Registry.clear();
     _alternativeO2Registry.clear();
+    _tabulatedO2.clear();
+
+    auto resolve = [this](pot2 *ptr) -> pot2 * {
+        auto it = _tabulationRequests.find(ptr->getId());
+        if (it == _tabulationRequests.end()) {
+            return ptr;
+        }
+        _tabulatedO2.push_back(std::make_shared<TabulatedPotential>(*ptr, std::get<0>(it->second),
+                                                                    std::get<1>(it->second)));
+        return _tabulatedO2.back().get();
+    };
 
     coll::for_each_value(potentialO1RegistryInternal, [&](const particle_type_type type, const pot1_ptr &ptr) {
         (potentialO1Registry)[type].push_back(ptr.get());
     });
-    coll::for_each_value(potentialO2RegistryInternal, [&](const pair &type, const pot2_ptr &ptr) {
-        (potentialO2Registry)[type].push_back(ptr.get());
-        _alternativeO2Registry[std::get<0>(type)][std::get<1>(type)].push_back(ptr.get());
+    coll::for_each_value(potentialO2RegistryInternal, [&](const pair &type, const pot2_ptr &p) {
+        auto ptr = resolve(p.get());
+        (potentialO2Registry)[type].push_back(ptr);
+        _alternativeO2Registry[std::get<0>(type)][std::get<1>(type)].push_back(ptr);
         if(std::get<0>(type) != std::get<1>(type)) {
-            _alternativeO2Registry[std::get<1>(type)][std::get<0>(type)].push_back(ptr.get());
+            _alternativeO2Registry[std::get<1>(type)][std::get<0>(type)].push_back(ptr);
         }
     });
     coll::for_each_value(potentialO1RegistryExternal, [&](const particle_type_type type, pot1 *ptr) {
         (potentialO1Registry)[type].push_back(ptr);
     });
-    coll::for_each_value(potentialO2RegistryExternal, [&](const pair &type, pot2 *ptr) {
+    coll::for_each_value(potentialO2RegistryExternal, [&](const pair &type, pot2 *p) {
+        auto ptr = resolve(p);
         (potentialO2Registry)[type].push_back(ptr);
         _alternativeO2Registry[std::get<0>(type)][std::get<1>(type)].push_back(ptr);
         if(std::get<0>(type) != std::get<1>(type)) {
             _alternativeO2Registry[std::get<1>(type)][std::get<0>(type)].push_back(ptr);
         }
     });
+    _tableO1.build(potentialO1Registry);
+    _tableO2.build(potentialO2Registry);
+    _interacting.clear();
+    for (const auto type : _types.get().typesFlat()) {
+        if (type >= _interacting.size()) {
+            _interacting.resize(type + 1_z, false);
+        }
+        _interacting[type] = _tableO1.begin(type) != _tableO1.end(type) || _tableO2.interacts(type)
+                             || _types.get().infoOf(type).flavor == particleflavor::TOPOLOGY;
+    }
 }
 
 inline std::string PotentialRegistry::describe() const {
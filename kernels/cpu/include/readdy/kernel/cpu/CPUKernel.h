@@ -112,6 +112,15 @@ public:
 
     void initialize() override;
 
+    /**
+     * If requested by the neighbor list configuration (auto_tune), times a few trial steps for a set of candidate
+     * combinations of cell radius, skin, and Verlet lists and stores the fastest one in the configuration. The
+     * particle positions are restored afterwards.
+     * @param timeStep the time step of the trial steps
+     * @param node perf node, receives one subnode per candidate and one naming the selected candidate
+     */
+    void tune(scalar timeStep, const util::PerformanceNode &node) override;
+
     void finalize() override {
         readdy::model::Kernel::finalize();
     }
@@ -47,6 +47,7 @@
 #include <readdy/kernel/cpu/data/DefaultDataContainer.h>
 #include <readdy/kernel/cpu/nl/CellLinkedList.h>
 #include <readdy/kernel/cpu/nl/ContiguousCellLinkedList.h>
+#include <readdy/kernel/cpu/nl/PairList.h>
 #include <readdy/kernel/cpu/data/ObservableData.h>
 
 namespace readdy {
@@ -64,6 +65,7 @@ public:
     using topology_ref = std::unique_ptr<topology>;
     using topologies_vec = readdy::util::index_persistent_vector<topology_ref>;
     using neighbor_list = nl::CompactCellLinkedList;
+    using pair_list = nl::PairList;
 
     CPUStateModel(data_type &data, const readdy::model::Context &context, thread_pool &pool,
                   readdy::model::top::TopologyActionFactory const* taf);
@@ -78,14 +80,33 @@ public:
     void configure(const readdy::conf::cpu::Configuration &configuration) {
         const auto& nl = configuration.neighborList;
         _neighborListCellRadius = nl.cll_radius;
+        _neighborListSkin = static_cast<scalar>(nl.skin);
+        _neighborList->verlet() = nl.verlet;
+        _neighborList->hilbertSortInterval() = nl.hilbert_sort_interval;
+        _neighborList->hilbertSortThreshold() = static_cast<scalar>(nl.hilbert_sort_threshold);
+        _data.get().compactionThreshold() = static_cast<scalar>(nl.compaction_threshold);
+        _neighborList->sortByCell() = nl.sort_by_cell;
+        _neighborList->smallCutoff() = static_cast<scalar>(nl.small_cutoff);
+        _neighborList->sparse() = nl.sparse_cells;
+        _pairList->enabled() = nl.pair_list;
+        _data.get().idBlock().reset(configuration.particleData.id_block_size);
+        if (_data.get().idsIndexed() != configuration.particleData.index_ids) {
+            _data.get().indexIds(configuration.particleData.index_ids);
+        }
     }
 
     const std::vector<Vec3> getParticlePositions() const override;
 
     const std::vector<particle_type> getParticles() const override;
 
+    /**
+     * Takes constant time per particle if the id index of the particle data is enabled (see
+     * conf::cpu::ParticleData::index_ids), otherwise the particle data is scanned once.
+     */
+    std::vector<particle_type> getParticlesForIds(const std::vector<particle_type::id_type> &ids) const override;
+
     void initializeNeighborList(scalar skin, const util::PerformanceNode &node) {
-        _neighborList->setUp(skin, _neighborListCellRadius, node.subnode("set_up"));
+        _neighborList->setUp(std::max(skin, _neighborListSkin), _neighborListCellRadius, node.subnode("set_up"));
         _neighborList->update(node.subnode("update"));
     };
 
@@ -109,6 +130,10 @@ public:
         getParticleData()->addParticles(p);
     };
 
+    void addParticles(particle_type_type type, const std::vector<Vec3> &positions) override {
+        getParticleData()->addParticles(type, positions);
+    };
+
     void removeParticle(const particle_type &p) override {
         getParticleData()->removeParticle(p);
     };
@@ -158,6 +183,25 @@ public:
         return _neighborList.get();
     };
 
+    pair_list &pairList() {
+        return *_pairList;
+    };
+
+    const pair_list &pairList() const {
+        return *_pairList;
+    };
+
+    /**
+     * Brings the pair list in sync with the neighbor list, if it is enabled. The pairs are only collected anew if the
+     * neighbor list changed since the last call.
+     * @param node perf node
+     */
+    void updatePairList(const util::PerformanceNode &node) {
+        if (_pairList->enabled()) {
+            _pairList->update(node);
+        }
+    };
+
     void clearNeighborList() override {
         clearNeighborList({});
     };
@@ -217,7 +261,9 @@ private:
     std::reference_wrapper<const readdy::model::Context> _context;
     std::reference_wrapper<data_type> _data;
     std::unique_ptr<neighbor_list> _neighborList;
+    std::unique_ptr<pair_list> _pairList;
     neighbor_list::cell_radius_type _neighborListCellRadius {1};
+    scalar _neighborListSkin {0};
     std::unique_ptr<readdy::signals::scoped_connection> _reorderConnection;
     std::reference_wrapper<const readdy::model::top::TopologyActionFactory> _topologyActionFactory;
     topologies_vec _topologies{};
@@ -0,0 +1,118 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * This file is part of ReaDDy.                                     *
+ *                                                                  *
+ * ReaDDy is free software: you can redistribute it and/or modify   *
+ * it under the terms of the GNU Lesser General Public License as   *
+ * published by the Free Software Foundation, either version 3 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU Lesser General Public License for more details.              *
+ *                                                                  *
+ * You should have received a copy of the GNU Lesser General        *
+ * Public License along with this program. If not, see              *
+ * <http://www.gnu.org/licenses/>.                                  *
+ ********************************************************************/
+
+
+/**
+ * Per-thread accumulators for values that are computed concurrently by the tasks of the thread pool and combined
+ * afterwards, e.g., energies and virials. Each worker thread owns one slot (addressed by the thread id that the pool
+ * passes to its tasks), so no synchronization is needed while accumulating. The instances are meant to be kept alive
+ * across time steps so that resetting them does not allocate.
+ *
+ * @file Reduction.h
+ * @brief Cache-line padded per-thread accumulators with a tree reduction.
+ * @author clonker
+ * @date 07.02.18
+ */
+
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <readdy/common/common.h>
+
+namespace readdy {
+namespace kernel {
+namespace cpu {
+
+static constexpr std::size_t cacheLineSize = 64;
+
+template<typename T>
+class Reduction {
+public:
+    using value_type = T;
+
+    Reduction() = default;
+
+    explicit Reduction(std::size_t nThreads, const T &identity = T{}) {
+        reset(nThreads, identity);
+    }
+
+    /**
+     * Sets all slots to the identity, slots are only (re)allocated if the number of threads changed.
+     * @param nThreads the number of threads
+     * @param identity the neutral element of the reduction
+     */
+    void reset(std::size_t nThreads, const T &identity) {
+        if (_slots.size() != nThreads) {
+            _slots.resize(nThreads);
+        }
+        for (auto &slot : _slots) {
+            slot.value = identity;
+        }
+    }
+
+    /**
+     * The accumulator of a thread.
+     * @param tid the thread id
+     * @return reference to the accumulator
+     */
+    T &local(std::size_t tid) {
+        return _slots[tid].value;
+    }
+
+    const T &local(std::size_t tid) const {
+        return _slots[tid].value;
+    }
+
+    std::size_t size() const {
+        return _slots.size();
+    }
+
+    /**
+     * Combines the accumulators pairwise in a tree, the slots are modified in the process, so the reduction has to be
+     * reset before accumulating again.
+     * @param op the (associative) reduction operation
+     * @return the reduced value
+     */
+    template<typename BinaryOp = std::plus<T>>
+    const T &reduce(BinaryOp op = {}) {
+        const auto n = _slots.size();
+        for (std::size_t stride = 1; stride < n; stride *= 2) {
+            for (std::size_t i = 0; i + stride < n; i += 2 * stride) {
+                _slots[i].value = op(_slots[i].value, _slots[i + stride].value);
+            }
+        }
+        return _slots.front().value;
+    }
+
+private:
+    struct Slot {
+        T value;
+        // keeps the values of different threads on different cache lines regardless of the allocation's alignment
+        char padding[cacheLineSize];
+    };
+
+    std::vector<Slot> _slots;
+};
+
+}
+}
+}
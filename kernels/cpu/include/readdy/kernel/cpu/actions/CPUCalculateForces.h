@@ -33,6 +33,8 @@
 
 #include <readdy/model/actions/Actions.h>
 #include <readdy/kernel/cpu/CPUKernel.h>
+#include <readdy/kernel/cpu/Reduction.h>
+#include <readdy/kernel/cpu/actions/ExternalLanes.h>
 #include <readdy/common/thread/barrier.h>
 
 namespace readdy {
@@ -40,9 +42,11 @@ namespace kernel {
 namespace cpu {
 namespace actions {
 class CPUCalculateForces : public readdy::model::actions::CalculateForces {
-    using data_bounds = std::tuple<data::EntryDataContainer::iterator, data::EntryDataContainer::iterator>;
-    using nl_bounds = std::tuple<std::size_t, std::size_t>;
+    using index_bounds = std::tuple<const std::size_t *, const std::size_t *>;
+    using nl_bounds = std::tuple<const nl::CellLinkedList::CellBlock *, const nl::CellLinkedList::CellBlock *>;
+    using pair_bounds = std::tuple<const nl::PairList::pairs *, const nl::PairList::pairs *>;
     using top_bounds = std::tuple<CPUStateModel::topologies_vec::const_iterator, CPUStateModel::topologies_vec::const_iterator>;
+    using virial_type = _internal::ReaDDyMatrix33<accumulator_type>;
 public:
 
     explicit CPUCalculateForces(CPUKernel *kernel) : kernel(kernel) {}
@@ -52,22 +56,34 @@ public:
 protected:
 
     template<bool COMPUTE_VIRIAL>
-    static void calculate_order2(std::size_t, nl_bounds nlBounds, CPUStateModel::data_type *data,
-                                 const CPUStateModel::neighbor_list &nl, std::promise<scalar> &energyPromise,
-                                 std::promise<Matrix33> &virialPromise,
-                                 model::potentials::PotentialRegistry::potential_o2_registry pot2,
-                                 model::Context::shortest_dist_fun d);
+    static void calculate_order2(std::size_t tid, nl_bounds nlBounds, CPUStateModel::data_type *data,
+                                 const CPUStateModel::neighbor_list &nl, Reduction<accumulator_type> &energy,
+                                 Reduction<virial_type> &virial,
+                                 const model::potentials::PairPotentialTable &pot2,
+                                 const model::Context &context);
 
-    static void calculate_topologies(std::size_t /*tid*/, top_bounds topBounds, model::top::TopologyActionFactory *taf,
-                                     std::promise<scalar> &energyPromise);
+    template<bool COMPUTE_VIRIAL>
+    static void calculate_order2_pairs(std::size_t tid, pair_bounds pairBounds, CPUStateModel::data_type *data,
+                                       Reduction<accumulator_type> &energy, Reduction<virial_type> &virial,
+                                       const model::potentials::PairPotentialTable &pot2);
+
+    static void calculate_topologies(std::size_t tid, top_bounds topBounds, model::top::TopologyActionFactory *taf,
+                                     Reduction<accumulator_type> &energy);
 
 
-    static void calculate_order1(std::size_t /*tid*/, data_bounds dataBounds,
-                                 std::promise<scalar> &energyPromise, CPUStateModel::data_type *data,
-                                 model::potentials::PotentialRegistry::potential_o1_registry pot1,
-                                 model::Context::shortest_dist_fun d);
+    static void calculate_order1(std::size_t tid, index_bounds indexBounds,
+                                 Reduction<accumulator_type> &energy, CPUStateModel::data_type *data,
+                                 const model::potentials::ExternalPotentialTable &pot1,
+                                 std::vector<std::vector<ExternalLanes>> &buckets);
 
     CPUKernel *const kernel;
+    // per-thread accumulators, kept across time steps
+    Reduction<accumulator_type> _energies;
+    Reduction<virial_type> _virials;
+    // indices of the particles that can feel a force, see PotentialRegistry::interacting
+    std::vector<std::size_t> _active;
+    // per-thread buckets of the first order potentials by particle type, kept across time steps
+    std::vector<std::vector<ExternalLanes>> _buckets;
 };
 }
 }
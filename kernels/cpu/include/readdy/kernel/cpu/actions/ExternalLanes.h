@@ -0,0 +1,107 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * This file is part of ReaDDy.                                     *
+ *                                                                  *
+ * ReaDDy is free software: you can redistribute it and/or modify   *
+ * it under the terms of the GNU Lesser General Public License as   *
+ * published by the Free Software Foundation, either version 3 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU Lesser General Public License for more details.              *
+ *                                                                  *
+ * You should have received a copy of the GNU Lesser General        *
+ * Public License along with this program. If not, see              *
+ * <http://www.gnu.org/licenses/>.                                  *
+ ********************************************************************/
+
+
+/**
+ * Structure-of-arrays buffer for the particles of one type that are subject to first order potentials. The positions
+ * of the bucket are gathered into contiguous x/y/z lanes, each potential of the type is then applied to the whole
+ * bucket in one vectorized pass, and the accumulated forces are scattered back afterwards.
+ *
+ * @file ExternalLanes.h
+ * @brief Structure-of-arrays bucket of particle positions for the batched evaluation of first order potentials.
+ * @author clonker
+ * @date 08.02.18
+ */
+
+#pragma once
+
+#include <vector>
+#include <readdy/common/common.h>
+#include <readdy/common/ReaDDyVec3.h>
+#include <readdy/model/potentials/ExternalPotentialTable.h>
+
+namespace readdy {
+namespace kernel {
+namespace cpu {
+namespace actions {
+
+class ExternalLanes {
+public:
+    void clear() {
+        _indices.clear();
+        _x.clear();
+        _y.clear();
+        _z.clear();
+    }
+
+    void push_back(std::size_t index, const Vec3 &pos) {
+        _indices.push_back(index);
+        _x.push_back(pos.x);
+        _y.push_back(pos.y);
+        _z.push_back(pos.z);
+    }
+
+    std::size_t size() const {
+        return _indices.size();
+    }
+
+    bool empty() const {
+        return _indices.empty();
+    }
+
+    std::size_t index(std::size_t lane) const {
+        return _indices[lane];
+    }
+
+    /**
+     * The force accumulated in the lane, valid after evaluate().
+     */
+    Vec3 force(std::size_t lane) const {
+        return {_fx[lane], _fy[lane], _fz[lane]};
+    }
+
+    /**
+     * The energy accumulated in the lane, valid after evaluate().
+     */
+    scalar energy(std::size_t lane) const {
+        return _energy[lane];
+    }
+
+    /**
+     * Evaluates a range of first order potentials for all lanes, overwriting previously accumulated forces and
+     * energies. This is the vectorized part, it is compiled for several instruction sets (if supported by the
+     * compiler) and the matching one is selected at runtime.
+     * @param begin the first potential
+     * @param end the end of the potentials
+     */
+    void evaluate(model::potentials::ExternalPotentialTable::const_iterator begin,
+                  model::potentials::ExternalPotentialTable::const_iterator end);
+
+private:
+    std::vector<std::size_t> _indices;
+    std::vector<scalar> _x, _y, _z;
+    std::vector<scalar> _fx, _fy, _fz, _energy;
+};
+
+}
+}
+}
+}
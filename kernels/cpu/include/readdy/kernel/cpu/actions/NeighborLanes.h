@@ -0,0 +1,123 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * This file is part of ReaDDy.                                     *
+ *                                                                  *
+ * ReaDDy is free software: you can redistribute it and/or modify   *
+ * it under the terms of the GNU Lesser General Public License as   *
+ * published by the Free Software Foundation, either version 3 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU Lesser General Public License for more details.              *
+ *                                                                  *
+ * You should have received a copy of the GNU Lesser General        *
+ * Public License along with this program. If not, see              *
+ * <http://www.gnu.org/licenses/>.                                  *
+ ********************************************************************/
+
+
+/**
+ * Structure-of-arrays buffer for the neighbor candidates of a single particle. The candidates' coordinates are gathered
+ * into contiguous x/y/z lanes so that the minimum image differences and squared distances can be computed for all of
+ * them in one vectorized pass.
+ *
+ * @file NeighborLanes.h
+ * @brief Structure-of-arrays buffer of neighbor coordinates with a vectorized distance computation.
+ * @author clonker
+ * @date 06.02.18
+ */
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <readdy/common/common.h>
+#include <readdy/common/ReaDDyVec3.h>
+
+namespace readdy {
+namespace kernel {
+namespace cpu {
+namespace actions {
+
+class NeighborLanes {
+public:
+    NeighborLanes(const std::array<scalar, 3> &boxSize, const std::array<bool, 3> &periodic);
+
+    void clear() {
+        _size = 0;
+    }
+
+    void push_back(std::size_t index, const Vec3 &pos) {
+        if (_size == _indices.size()) {
+            grow();
+        }
+        _indices[_size] = index;
+        _x[_size] = pos.x;
+        _y[_size] = pos.y;
+        _z[_size] = pos.z;
+        ++_size;
+    }
+
+    std::size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    std::size_t index(std::size_t lane) const {
+        return _indices[lane];
+    }
+
+    /**
+     * The minimum image difference (neighbor - particle) of the lane, valid after computeDifferences() or
+     * computePlainDifferences().
+     */
+    Vec3 difference(std::size_t lane) const {
+        return {_dx[lane], _dy[lane], _dz[lane]};
+    }
+
+    /**
+     * The squared distance of the lane, valid after computeDifferences() or computePlainDifferences().
+     */
+    scalar distSquared(std::size_t lane) const {
+        return _d2[lane];
+    }
+
+    /**
+     * Computes minimum image differences and squared distances of all lanes with respect to a position. This is the
+     * vectorized part, it is compiled for several instruction sets (if supported by the compiler) and the matching
+     * one is selected at runtime.
+     * @param pos the position of the particle
+     */
+    void computeDifferences(const Vec3 &pos);
+
+    /**
+     * Computes plain differences and squared distances of all lanes with respect to a position, for lanes that were
+     * already shifted to the periodic image next to the particle.
+     * @param pos the position of the particle
+     */
+    void computePlainDifferences(const Vec3 &pos);
+
+private:
+    void grow();
+
+    std::size_t _size{0};
+    // period per axis, 0 for non-periodic axes
+    std::array<scalar, 3> _period;
+    // half period per axis, infinity for non-periodic axes
+    std::array<scalar, 3> _halfPeriod;
+    std::vector<std::size_t> _indices;
+    std::vector<scalar> _x, _y, _z;
+    std::vector<scalar> _dx, _dy, _dz, _d2;
+};
+
+}
+}
+}
+}
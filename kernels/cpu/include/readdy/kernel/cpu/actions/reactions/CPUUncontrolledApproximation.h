@@ -31,6 +31,8 @@
 
 #pragma once
 #include <readdy/kernel/cpu/CPUKernel.h>
+#include <readdy/kernel/cpu/Reduction.h>
+#include <readdy/kernel/cpu/actions/reactions/Event.h>
 
 namespace readdy {
 namespace kernel {
@@ -64,6 +66,8 @@ public:
 
 protected:
     CPUKernel *const kernel;
+    // events found by each thread, kept across time steps
+    Reduction<std::vector<Event>> events;
 };
 }
 }
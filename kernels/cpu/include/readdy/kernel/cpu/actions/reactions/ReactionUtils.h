@@ -70,10 +70,10 @@ data_t::DataUpdate handleEventsGillespie(
         bool filterEventsInAdvance, bool approximateRate,
         std::vector<event_t> &&events, std::vector<record_t> *maybeRecords, reaction_counts_map *maybeCounts);
 
-template<typename ParticleIndexCollection>
+template<typename ParticleIndexCollection, typename DistSquared>
 void gatherEvents(CPUKernel *const kernel, const ParticleIndexCollection &particles, const neighbor_list* nl,
                   const data_t *data, readdy::scalar &alpha, std::vector<event_t> &events,
-                  const readdy::model::Context::dist_squared_fun& d2) {
+                  const DistSquared &d2) {
     const auto& reaction_registry = kernel->context().reactions();
     for (const auto index : particles) {
         const auto &entry = data->entry_at(index);
@@ -97,6 +97,27 @@ void gatherEvents(CPUKernel *const kernel, const ParticleIndexCollection &partic
     }
 
     // order 2
+    const auto &pairList = kernel->getCPUKernelStateModel().pairList();
+    if (pairList.enabled() && pairList.upToDate()) {
+        pairList.forEachPair([&](const auto &pair) {
+            const auto idx1 = std::min(pair.i, pair.j);
+            const auto idx2 = std::max(pair.i, pair.j);
+            const auto &entry = data->entry_at(idx1);
+            const auto &neighbor = data->entry_at(idx2);
+            const auto &reactions = kernel->context().reactions().order2ByType(entry.type, neighbor.type);
+            for (auto itReactions = reactions.begin(); itReactions < reactions.end(); ++itReactions) {
+                const auto &react = *itReactions;
+                const auto rate = react->rate();
+                if (rate > 0 && pair.distSquared < react->eductDistanceSquared()) {
+                    alpha += rate;
+                    events.emplace_back(2, react->nProducts(), idx1, idx2, rate, alpha,
+                                        static_cast<event_t::reaction_index_type>(itReactions - reactions.begin()),
+                                        entry.type, neighbor.type);
+                }
+            }
+        });
+        return;
+    }
     for(std::size_t cell = 0; cell < nl->nCells(); ++cell) {
         for(auto particleIt = nl->particlesBegin(cell); particleIt != nl->particlesEnd(cell); ++particleIt) {
             const auto &idx1 = *particleIt;
@@ -138,8 +159,9 @@ void performReaction(data_t* data, const readdy::model::Context& context, data_t
                      Reaction* reaction, record_t* record) {
     const auto& pbc = context.applyPBCFun();
     const auto &shortestDifferenceFun = context.shortestDifferenceFun();
-    auto& entry1 = data->entry_at(idx1);
-    auto& entry2 = data->entry_at(idx2);
+    auto entry1 = data->entry_at(idx1);
+    auto entry2 = data->entry_at(idx2);
+    auto& ids = data->idBlock();
     if(record) {
         record->type = static_cast<int>(reaction->type());
         record->where = (entry1.pos + entry2.pos) / 2.;
@@ -154,20 +176,20 @@ void performReaction(data_t* data, const readdy::model::Context& context, data_t
             break;
         }
         case reaction_type::Conversion: {
-            entry1.type = reaction->products()[0];
-            entry1.id = readdy::model::Particle::nextId();
+            data->setType(idx1, reaction->products()[0]);
+            data->setId(idx1, ids.next());
             if(record) record->products[0] = entry1.id;
             break;
         }
         case reaction_type::Enzymatic: {
             if (entry1.type == reaction->educts()[1]) {
                 // p1 is the catalyst
-                entry2.type = reaction->products()[0];
-                entry2.id = readdy::model::Particle::nextId();
+                data->setType(idx2, reaction->products()[0]);
+                data->setId(idx2, ids.next());
             } else {
                 // p2 is the catalyst
-                entry1.type = reaction->products()[0];
-                entry1.id = readdy::model::Particle::nextId();
+                data->setType(idx1, reaction->products()[0]);
+                data->setId(idx1, ids.next());
             }
             if(record) {
                 record->products[0] = entry1.id;
@@ -180,11 +202,11 @@ void performReaction(data_t* data, const readdy::model::Context& context, data_t
             n3 /= std::sqrt(n3 * n3);
 
             //readdy::model::Particle p (, reaction->products()[1]);
-            const auto id = readdy::model::Particle::nextId();
+            const auto id = ids.next();
             newEntries.emplace_back(pbc(entry1.pos - reaction->weight2() * reaction->productDistance() * n3), reaction->products()[1], id);
 
-            entry1.type = reaction->products()[0];
-            entry1.id = readdy::model::Particle::nextId();
+            data->setType(idx1, reaction->products()[0]);
+            data->setId(idx1, ids.next());
             data->displace(idx1, reaction->weight1() * reaction->productDistance() * n3);
             if(record) {
                 record->products[0] = entry1.id;
@@ -198,10 +220,10 @@ void performReaction(data_t* data, const readdy::model::Context& context, data_t
             const auto difference = shortestDifferenceFun(e1Pos, e2Pos);
             if (reaction->educts()[0] == entry1.type) {
                 newEntries.emplace_back(pbc(entry1.pos + reaction->weight1() * difference),
-                                        reaction->products()[0], readdy::model::Particle::nextId());
+                                        reaction->products()[0], ids.next());
             } else {
                 newEntries.emplace_back(pbc(entry1.pos + reaction->weight2() * difference),
-                                        reaction->products()[0], readdy::model::Particle::nextId());
+                                        reaction->products()[0], ids.next());
             }
             decayedEntries.push_back(idx1);
             decayedEntries.push_back(idx2);
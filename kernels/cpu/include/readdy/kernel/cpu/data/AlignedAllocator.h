@@ -0,0 +1,95 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * This file is part of ReaDDy.                                     *
+ *                                                                  *
+ * ReaDDy is free software: you can redistribute it and/or modify   *
+ * it under the terms of the GNU Lesser General Public License as   *
+ * published by the Free Software Foundation, either version 3 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU Lesser General Public License for more details.              *
+ *                                                                  *
+ * You should have received a copy of the GNU Lesser General        *
+ * Public License along with this program. If not, see              *
+ * <http://www.gnu.org/licenses/>.                                  *
+ ********************************************************************/
+
+
+/**
+ * Allocator for the field arrays of the particle data. The arrays start at a cache line boundary, so that the ranges
+ * handed to the threads of the pool do not share more cache lines than necessary and vectorized loops over the
+ * arrays start aligned.
+ *
+ * @file AlignedAllocator.h
+ * @brief Allocator returning memory aligned to a cache line.
+ * @author clonker
+ * @date 12.02.18
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+namespace readdy {
+namespace kernel {
+namespace cpu {
+namespace data {
+
+template<typename T, std::size_t Alignment = 64>
+class AlignedAllocator {
+    static_assert(Alignment >= alignof(void *) && (Alignment & (Alignment - 1)) == 0,
+                  "the alignment has to be a power of two that is at least the alignment of a pointer");
+public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment> &) noexcept {}
+
+    T *allocate(std::size_t n) {
+        if (n > (std::numeric_limits<std::size_t>::max() - Alignment - sizeof(void *)) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        // over-allocate and remember the start of the block right in front of the aligned memory
+        void *block = ::operator new(n * sizeof(T) + Alignment + sizeof(void *));
+        auto address = reinterpret_cast<std::uintptr_t>(block) + sizeof(void *);
+        address = (address + Alignment - 1) & ~static_cast<std::uintptr_t>(Alignment - 1);
+        reinterpret_cast<void **>(address)[-1] = block;
+        return reinterpret_cast<T *>(address);
+    }
+
+    void deallocate(T *p, std::size_t) noexcept {
+        if (p != nullptr) {
+            ::operator delete(reinterpret_cast<void **>(p)[-1]);
+        }
+    }
+};
+
+template<typename T, typename U, std::size_t Alignment>
+bool operator==(const AlignedAllocator<T, Alignment> &, const AlignedAllocator<U, Alignment> &) noexcept {
+    return true;
+}
+
+template<typename T, typename U, std::size_t Alignment>
+bool operator!=(const AlignedAllocator<T, Alignment> &, const AlignedAllocator<U, Alignment> &) noexcept {
+    return false;
+}
+
+}
+}
+}
+}
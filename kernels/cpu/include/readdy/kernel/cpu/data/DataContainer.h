@@ -21,10 +21,12 @@
 
 
 /**
- * << detailed description >>
+ * The particle data of the CPU kernel. Each field of the particles (positions, forces, types, ids, flags, topology
+ * indices) is stored in an array of its own, so that a pass over the particles only streams the fields it uses.
+ * Access to a whole particle goes through EntryRef, which refers to the particle's element in each of the arrays.
  *
  * @file DataContainer.h
- * @brief << brief description >>
+ * @brief Structure-of-arrays particle data of the CPU kernel.
  * @author clonker
  * @date 14.09.17
  * @copyright GNU Lesser General Public License v3.0
@@ -32,17 +34,104 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
 #include <readdy/model/Context.h>
 #include <readdy/common/thread/Config.h>
 #include <readdy/common/signals.h>
 #include <readdy/common/Utils.h>
+#include "IdBlock.h"
+#include "AlignedAllocator.h"
 
 namespace readdy {
 namespace kernel {
 namespace cpu {
 namespace data {
 
+/**
+ * A particle as passed into and out of the data container, e.g., the new entries of a DataUpdate. The entry is kept
+ * free of virtual functions so that it is trivially copyable and does not carry a vtable pointer. Inside the container
+ * the fields are stored in separate arrays, see EntryRef.
+ */
+struct Entry {
+    using Particle = readdy::model::Particle;
+
+    explicit Entry(const Particle &particle)
+            : pos(particle.getPos()), force(), type(particle.getType()), deactivated(false), id(particle.getId()) {}
+
+    Entry(Particle::pos_type pos, particle_type_type type, Particle::id_type id)
+            : pos(pos), type(type), deactivated(false), id(id) {}
+
+    Entry(const Entry &) = default;
+
+    Entry &operator=(const Entry &) = default;
+
+    Entry(Entry &&) noexcept = default;
+
+    Entry &operator=(Entry &&) noexcept = default;
+
+    ~Entry() = default;
+
+    Vec3 pos;
+    Vec3 force;
+    Particle::type_type type;
+    bool deactivated;
+    Particle::id_type id;
+    std::ptrdiff_t topology_index{-1};
+};
+
+static_assert(std::is_trivially_copyable<Entry>::value, "entries are copied and reordered in bulk");
+static_assert(sizeof(Entry) <= 2 * sizeof(Vec3) + 3 * sizeof(std::ptrdiff_t),
+              "unexpected padding in the entry layout");
+
+/**
+ * Type of the per-particle flags, one byte instead of a bit so that the flags of different particles can be written
+ * concurrently.
+ */
+using flag_type = std::uint8_t;
+
+/**
+ * Reference to one particle of a data container. It binds to the particle's element in each of the field arrays and
+ * can be used like a reference to an Entry, i.e., the fields are read and assigned through it.
+ * @tparam Const whether the fields are read-only
+ */
+template<bool Const>
+struct EntryRef {
+    template<typename U>
+    using field_ref = std::conditional_t<Const, const U &, U &>;
+
+    EntryRef(field_ref<Vec3> pos, field_ref<Vec3> force, field_ref<Entry::Particle::type_type> type,
+             field_ref<flag_type> deactivated, field_ref<Entry::Particle::id_type> id,
+             field_ref<std::ptrdiff_t> topology_index)
+            : pos(pos), force(force), type(type), deactivated(deactivated), id(id), topology_index(topology_index) {}
+
+    template<bool C = Const, typename = std::enable_if_t<C>>
+    EntryRef(const EntryRef<false> &other)
+            : EntryRef(other.pos, other.force, other.type, other.deactivated, other.id, other.topology_index) {}
+
+    /**
+     * @return a copy of the referenced particle
+     */
+    operator Entry() const {
+        Entry entry(pos, type, id);
+        entry.force = force;
+        entry.deactivated = deactivated != 0;
+        entry.topology_index = topology_index;
+        return entry;
+    }
+
+    field_ref<Vec3> pos;
+    field_ref<Vec3> force;
+    field_ref<Entry::Particle::type_type> type;
+    field_ref<flag_type> deactivated;
+    field_ref<Entry::Particle::id_type> id;
+    field_ref<std::ptrdiff_t> topology_index;
+};
+
 template<typename T>
 class DataContainer {
 public:
@@ -57,8 +146,145 @@ public:
     using topology_index_t = std::ptrdiff_t;
     using size_type = typename Entries::size_type;
 
-    using iterator = typename Entries::iterator;
-    using const_iterator = typename Entries::const_iterator;
+    /**
+     * Array of one field of all particles, deactivated ones included.
+     */
+    template<typename U>
+    using field_array = std::vector<U, AlignedAllocator<U>>;
+
+    using reference = EntryRef<false>;
+    using const_reference = EntryRef<true>;
+
+    /**
+     * Random access iterator over the particles, dereferencing yields an EntryRef.
+     */
+    template<bool Const>
+    class basic_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = EntryRef<Const>;
+        using container_type = std::conditional_t<Const, const DataContainer, DataContainer>;
+
+        /**
+         * Result of operator->, keeps the reference alive for the member access.
+         */
+        struct pointer {
+            reference ref;
+
+            const reference *operator->() const {
+                return &ref;
+            }
+        };
+
+        basic_iterator() = default;
+
+        basic_iterator(container_type *container, size_type index) : _container(container), _index(index) {}
+
+        template<bool C = Const, typename = std::enable_if_t<C>>
+        basic_iterator(const basic_iterator<false> &other) : _container(other._container), _index(other._index) {}
+
+        reference operator*() const {
+            return _container->ref(_index);
+        }
+
+        pointer operator->() const {
+            return {**this};
+        }
+
+        reference operator[](difference_type n) const {
+            return _container->ref(_index + n);
+        }
+
+        basic_iterator &operator++() {
+            ++_index;
+            return *this;
+        }
+
+        basic_iterator operator++(int) {
+            auto copy = *this;
+            ++_index;
+            return copy;
+        }
+
+        basic_iterator &operator--() {
+            --_index;
+            return *this;
+        }
+
+        basic_iterator operator--(int) {
+            auto copy = *this;
+            --_index;
+            return copy;
+        }
+
+        basic_iterator &operator+=(difference_type n) {
+            _index += n;
+            return *this;
+        }
+
+        basic_iterator &operator-=(difference_type n) {
+            _index -= n;
+            return *this;
+        }
+
+        basic_iterator operator+(difference_type n) const {
+            return {_container, _index + n};
+        }
+
+        friend basic_iterator operator+(difference_type n, const basic_iterator &it) {
+            return it + n;
+        }
+
+        basic_iterator operator-(difference_type n) const {
+            return {_container, _index - n};
+        }
+
+        difference_type operator-(const basic_iterator &other) const {
+            return static_cast<difference_type>(_index) - static_cast<difference_type>(other._index);
+        }
+
+        bool operator==(const basic_iterator &other) const {
+            return _index == other._index;
+        }
+
+        bool operator!=(const basic_iterator &other) const {
+            return _index != other._index;
+        }
+
+        bool operator<(const basic_iterator &other) const {
+            return _index < other._index;
+        }
+
+        bool operator>(const basic_iterator &other) const {
+            return _index > other._index;
+        }
+
+        bool operator<=(const basic_iterator &other) const {
+            return _index <= other._index;
+        }
+
+        bool operator>=(const basic_iterator &other) const {
+            return _index >= other._index;
+        }
+
+        /**
+         * @return the index of the particle in the container
+         */
+        size_type index() const {
+            return _index;
+        }
+
+    private:
+        template<bool> friend class basic_iterator;
+
+        container_type *_container {nullptr};
+        size_type _index {0};
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
 
     DataContainer(const readdy::model::Context &context, thread_pool &pool)
             : _context(context), _pool(pool), reorderSignal(std::make_shared<ReorderSignal>()) {};
@@ -66,7 +292,7 @@ public:
     virtual ~DataContainer() = default;
 
     std::size_t size() const {
-        return _entries.size();
+        return _pos.size();
     };
 
     virtual void reserve(std::size_t n) = 0;
@@ -76,8 +302,12 @@ public:
     };
 
     void clear() {
-        _entries.clear();
+        forEachField([](auto &field) {
+            field.clear();
+        });
         _blanks.clear();
+        _indexOfId.clear();
+        invalidateEdits();
     };
 
     void addParticle(const Particle &particle) {
@@ -102,103 +332,260 @@ public:
 
     virtual void addParticles(const std::vector<Particle> &particles) = 0;
 
+    /**
+     * Adds particles of one type without going through intermediate Particle objects, the ids are taken as one
+     * contiguous block.
+     * @param type the type of the particles
+     * @param positions the positions of the particles
+     */
+    virtual void addParticles(particle_type_type type, const std::vector<Vec3> &positions) = 0;
+
     virtual std::vector<size_type> addTopologyParticles(const std::vector<TopologyParticle> &topologyParticles) = 0;
 
     Particle getParticle(size_type index) const {
-        const auto& entry = *(_entries.begin() + index);
-        if(entry.deactivated) {
+        if(_deactivated[index]) {
             log::error("Requested deactivated particle at index {}!", index);
         }
-        return toParticle(entry);
+        return toParticle(ref(index));
     };
 
-    Particle toParticle(const T &e) const {
+    Particle toParticle(const_reference e) const {
         return readdy::model::Particle(e.pos, e.type, e.id);
     };
 
     void removeParticle(const Particle &particle) {
-        auto it_entries = begin();
-        std::size_t idx = 0;
-        for(; it_entries != end(); ++it_entries, ++idx) {
-            if(!it_entries->deactivated && it_entries->id == particle.getId()) {
-                _blanks.push_back(idx);
-                it_entries->deactivated = true;
-                return;
-            }
+        const auto idx = findIndexForId(particle.getId());
+        if(idx < size()) {
+            unindexId(idx);
+            _blanks.push_back(idx);
+            _deactivated[idx] = true;
+            logEdit(idx);
+            return;
         }
         log::error("Tried to remove particle ({}) which did not exist or was already deactivated!", particle);
     };
 
     void removeParticle(size_type index) {
-        auto& p = *(_entries.begin() + index);
-        if(!p.deactivated) {
+        auto &deactivated = _deactivated[index];
+        if(!deactivated) {
+            unindexId(index);
             _blanks.push_back(index);
-            p.deactivated = true;
+            deactivated = true;
+            logEdit(index);
         } else {
             log::error("Tried to remove particle (index={}), that was already removed!", index);
         }
     };
 
     void removeEntry(size_type index) {
-        auto &entry = _entries.at(index);
-        if(!entry.deactivated) {
-            entry.deactivated = true;
+        auto &deactivated = _deactivated.at(index);
+        if(!deactivated) {
+            unindexId(index);
+            deactivated = true;
             _blanks.push_back(index);
+            logEdit(index);
         } else {
             log::critical("Tried removing particle {} which was already deactivated!", index);
         }
     };
 
     size_type getIndexForId(Particle::id_type id) const {
-        auto find_it = std::find_if(_entries.begin(), _entries.end(), [id](const T& e) {
-            return !e.deactivated && e.id == id;
-        });
-        if(find_it != _entries.end()) {
-            return static_cast<size_type>(std::distance(_entries.begin(), find_it));
+        const auto index = findIndexForId(id);
+        if(index < size()) {
+            return index;
         }
         throw std::out_of_range("requested id was not to be found in particle data");
     };
 
+    /**
+     * Looks up the indices of several active particles at once. With the id index (see indexIds()) each lookup takes
+     * constant time, otherwise the entries are scanned once for all ids together.
+     * @param ids the particle ids
+     * @return the indices in the same order
+     */
+    std::vector<size_type> getIndicesForIds(const std::vector<Particle::id_type> &ids) const {
+        std::vector<size_type> result;
+        result.reserve(ids.size());
+        if(_idsIndexed) {
+            for(auto id : ids) {
+                result.push_back(getIndexForId(id));
+            }
+        } else {
+            std::unordered_map<Particle::id_type, size_type> indices;
+            indices.reserve(ids.size());
+            for(auto id : ids) {
+                indices.emplace(id, size());
+            }
+            for(size_type index = 0; index < size(); ++index) {
+                if(!_deactivated[index]) {
+                    auto it = indices.find(_id[index]);
+                    if(it != indices.end()) {
+                        it->second = index;
+                    }
+                }
+            }
+            for(auto id : ids) {
+                const auto index = indices.at(id);
+                if(index == size()) {
+                    throw std::out_of_range("requested id was not to be found in particle data");
+                }
+                result.push_back(index);
+            }
+        }
+        return result;
+    };
+
+    /**
+     * Enables or disables the id index, a hash map from the id of each active particle to its index. It is kept up to
+     * date by all methods of the container, so that lookups by id take constant time. Code that changes the id of an
+     * entry has to go through setId().
+     * @param enabled whether to maintain the index
+     */
+    void indexIds(bool enabled) {
+        _idsIndexed = enabled;
+        _indexOfId.clear();
+        if(enabled) {
+            _indexOfId.reserve(size());
+            for(size_type index = 0; index < size(); ++index) {
+                indexId(index);
+            }
+        }
+    };
+
+    /**
+     * @return whether the id index is maintained, see indexIds()
+     */
+    bool idsIndexed() const {
+        return _idsIndexed;
+    };
+
+    /**
+     * Assigns a new id to an entry, keeping the id index up to date.
+     */
+    void setId(size_type index, Particle::id_type id) {
+        unindexId(index);
+        _id.at(index) = id;
+        indexId(index);
+    };
+
+    /**
+     * Changes the type of an entry. The change is logged as an edit, since the neighbor list and the pair list
+     * depend on the types.
+     */
+    void setType(size_type index, particle_type_type type) {
+        _type.at(index) = type;
+        logEdit(index);
+    };
+
+    /**
+     * The block out of which ids for newly created particles (e.g., reaction products) are taken.
+     */
+    IdBlock &idBlock() {
+        return _idBlock;
+    };
+
+    const IdBlock &idBlock() const {
+        return _idBlock;
+    };
+
     virtual iterator begin() {
-        return _entries.begin();
+        return {this, 0};
     };
 
     virtual iterator end() {
-        return _entries.end();
+        return {this, size()};
     };
 
     virtual const_iterator cbegin() const {
-        return _entries.cbegin();
+        return {this, 0};
     };
 
     virtual const_iterator cend() const {
-        return _entries.cend();
+        return {this, size()};
     };
 
     virtual const_iterator begin() const {
-        return _entries.cbegin();
+        return cbegin();
     };
 
     virtual const_iterator end() const {
-        return _entries.cend();
+        return cend();
     };
 
-    T &entry_at(size_type index) {
-        return _entries.at(index);
+    reference entry_at(size_type index) {
+        checkIndex(index);
+        return ref(index);
     }
 
-    const T &entry_at(size_type index) const {
-        return _entries.at(index);
+    const_reference entry_at(size_type index) const {
+        checkIndex(index);
+        return ref(index);
     }
 
-    const T &centry_at(size_type index) const {
-        return _entries.at(index);
+    const_reference centry_at(size_type index) const {
+        return entry_at(index);
     }
 
     const Particle::pos_type &pos(size_type index) const {
-        return _entries.at(index).pos;
+        return _pos.at(index);
     };
 
+    /**
+     * The positions of all particles, indexed like the entries. Passes that only need a few of the fields can run on
+     * the field arrays directly instead of going through entry_at() or the iterators.
+     */
+    field_array<Vec3> &positions() {
+        return _pos;
+    }
+
+    const field_array<Vec3> &positions() const {
+        return _pos;
+    }
+
+    /**
+     * The forces of all particles, see positions().
+     */
+    field_array<Vec3> &forces() {
+        return _force;
+    }
+
+    const field_array<Vec3> &forces() const {
+        return _force;
+    }
+
+    /**
+     * The types of all particles, see positions(). Types are changed through setType().
+     */
+    const field_array<particle_type_type> &types() const {
+        return _type;
+    }
+
+    /**
+     * The ids of all particles, see positions(). Ids are changed through setId().
+     */
+    const field_array<Particle::id_type> &ids() const {
+        return _id;
+    }
+
+    /**
+     * The deactivated flags of all particles, see positions(). Particles are deactivated through removeParticle() or
+     * removeEntry().
+     */
+    const field_array<flag_type> &deactivated() const {
+        return _deactivated;
+    }
+
+    /**
+     * The topology indices of all particles (-1 if a particle is not part of a topology), see positions().
+     */
+    field_array<topology_index_t> &topologyIndices() {
+        return _topologyIndex;
+    }
+
+    const field_array<topology_index_t> &topologyIndices() const {
+        return _topologyIndex;
+    }
+
     size_type getNDeactivated() const {
         return _blanks.size();
     }
@@ -228,49 +615,161 @@ public:
         return _pool.get();
     }
 
-    const auto &entries() const {
-        return _entries;
-    }
-
     const std::vector<size_type> &blanks() const {
         return _blanks;
     }
 
+    /**
+     * Indices of the entries that were added, replaced, removed, or displaced one by one (e.g., by reactions) since the
+     * last call to clearEdits(). They are only a complete description of the changes if editsComplete() is true.
+     * @return the edited indices, may contain duplicates
+     */
+    const std::vector<size_type> &edits() const {
+        return _edits;
+    }
+
+    /**
+     * @return false if the entries changed in bulk (e.g., integration of the equations of motion or reordering) since
+     * the last call to clearEdits()
+     */
+    bool editsComplete() const {
+        return _editsComplete;
+    }
+
+    /**
+     * Marks that potentially all entries changed, this has to be called by everything that moves particles without
+     * going through the methods of the data container.
+     */
+    void invalidateEdits() {
+        _edits.clear();
+        _editsComplete = false;
+    }
+
+    /**
+     * Called by the neighbor list once it is in sync with the entries again.
+     */
+    void clearEdits() {
+        _edits.clear();
+        _editsComplete = true;
+    }
+
 protected:
-    std::reference_wrapper<const readdy::model::Context> _context;
-    std::reference_wrapper<thread_pool> _pool;
+    reference ref(size_type index) {
+        return {_pos[index], _force[index], _type[index], _deactivated[index], _id[index], _topologyIndex[index]};
+    }
 
-    std::vector<size_type> _blanks {};
-    Entries _entries {};
+    const_reference ref(size_type index) const {
+        return {_pos[index], _force[index], _type[index], _deactivated[index], _id[index], _topologyIndex[index]};
+    }
 
-    std::shared_ptr<ReorderSignal> reorderSignal;
-};
+    void checkIndex(size_type index) const {
+        if(index >= size()) {
+            throw std::out_of_range("requested entry index is out of range");
+        }
+    }
 
-struct Entry {
-    using Particle = readdy::model::Particle;
+    /**
+     * Calls the function with each of the field arrays.
+     */
+    template<typename Function>
+    void forEachField(const Function &function) {
+        function(_pos);
+        function(_force);
+        function(_type);
+        function(_deactivated);
+        function(_id);
+        function(_topologyIndex);
+    }
 
-    explicit Entry(const Particle &particle)
-            : pos(particle.getPos()), force(), type(particle.getType()), deactivated(false), id(particle.getId()) {}
+    /**
+     * Overwrites the fields of the particle at the index.
+     */
+    void setEntry(size_type index, const T &entry) {
+        checkIndex(index);
+        _pos[index] = entry.pos;
+        _force[index] = entry.force;
+        _type[index] = entry.type;
+        _deactivated[index] = entry.deactivated;
+        _id[index] = entry.id;
+        _topologyIndex[index] = entry.topology_index;
+    }
 
-    Entry(Particle::pos_type pos, particle_type_type type, Particle::id_type id)
-            : pos(pos), type(type), id(id), deactivated(false) {}
+    /**
+     * Appends a particle to the field arrays.
+     */
+    void appendEntry(const T &entry) {
+        _pos.push_back(entry.pos);
+        _force.push_back(entry.force);
+        _type.push_back(entry.type);
+        _deactivated.push_back(entry.deactivated);
+        _id.push_back(entry.id);
+        _topologyIndex.push_back(entry.topology_index);
+    }
 
-    Entry(const Entry &) = default;
+    size_type findIndexForId(Particle::id_type id) const {
+        if(_idsIndexed) {
+            const auto it = _indexOfId.find(id);
+            return it != _indexOfId.end() ? it->second : size();
+        }
+        for(size_type index = 0; index < size(); ++index) {
+            if(!_deactivated[index] && _id[index] == id) {
+                return index;
+            }
+        }
+        return size();
+    }
 
-    Entry &operator=(const Entry &) = default;
+    void indexId(size_type index) {
+        if(_idsIndexed && !_deactivated[index]) {
+            _indexOfId[_id[index]] = index;
+        }
+    }
 
-    Entry(Entry &&) noexcept = default;
+    void unindexId(size_type index) {
+        if(_idsIndexed) {
+            // the entry at the index might be a stale (deactivated) one whose id was taken over elsewhere
+            const auto it = _indexOfId.find(_id[index]);
+            if(it != _indexOfId.end() && it->second == index) {
+                _indexOfId.erase(it);
+            }
+        }
+    }
 
-    Entry &operator=(Entry &&) noexcept = default;
+    void logEdit(size_type index) {
+        if (_editsComplete) {
+            if (_edits.size() < size()) {
+                _edits.push_back(index);
+            } else {
+                // processing the edits one by one would not be cheaper than rebuilding from scratch
+                invalidateEdits();
+            }
+        }
+    }
 
-    virtual ~Entry() = default;
+    std::reference_wrapper<const readdy::model::Context> _context;
+    std::reference_wrapper<thread_pool> _pool;
 
-    Vec3 force;
-    Vec3 pos;
-    std::ptrdiff_t topology_index{-1};
-    Particle::id_type id;
-    Particle::type_type type;
-    bool deactivated;
+    std::vector<size_type> _blanks {};
+
+    // the fields of the particles, one array per field
+    field_array<Vec3> _pos {};
+    field_array<Vec3> _force {};
+    field_array<particle_type_type> _type {};
+    field_array<flag_type> _deactivated {};
+    field_array<Particle::id_type> _id {};
+    field_array<topology_index_t> _topologyIndex {};
+
+    // indices of individually edited entries since the neighbor list was last in sync, see edits()
+    std::vector<size_type> _edits {};
+    bool _editsComplete {false};
+
+    // id of each active entry to its index, maintained if _idsIndexed, see indexIds()
+    bool _idsIndexed {false};
+    std::unordered_map<Particle::id_type, size_type> _indexOfId {};
+
+    IdBlock _idBlock {1};
+
+    std::shared_ptr<ReorderSignal> reorderSignal;
 };
 
 using EntryDataContainer = DataContainer<Entry>;
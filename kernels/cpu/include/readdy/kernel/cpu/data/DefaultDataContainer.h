@@ -53,26 +53,35 @@ public:
 
     explicit DefaultDataContainer(EntryDataContainer *entryDataContainer)
             : DataContainer(entryDataContainer->context(), entryDataContainer->pool()) {
-        _entries = entryDataContainer->entries();
+        reserve(entryDataContainer->size());
+        for (const auto &entry : *entryDataContainer) {
+            appendEntry(entry);
+        }
         _blanks = entryDataContainer->blanks();
     }
 
     DefaultDataContainer(const model::Context &context, thread_pool &pool) : DataContainer(context, pool) {};
 
     void reserve(std::size_t n) override {
-        _entries.reserve(n);
+        forEachField([n](auto &field) {
+            field.reserve(n);
+        });
     };
 
     size_type addEntry(Entry &&entry) override {
         if(!_blanks.empty()) {
             const auto idx = _blanks.back();
             _blanks.pop_back();
-            _entries.at(idx) = std::move(entry);
+            setEntry(idx, entry);
+            indexId(idx);
+            logEdit(idx);
             return idx;
         }
 
-        _entries.push_back(std::move(entry));
-        return _entries.size()-1;
+        appendEntry(entry);
+        indexId(size()-1);
+        logEdit(size()-1);
+        return size()-1;
     }
 
     void addParticles(const std::vector<Particle> &particles) override {
@@ -80,9 +89,47 @@ public:
             if(!_blanks.empty()) {
                 const auto idx = _blanks.back();
                 _blanks.pop_back();
-                _entries.at(idx) = Entry(p);
+                setEntry(idx, Entry(p));
+                indexId(idx);
+                logEdit(idx);
             } else {
-                _entries.emplace_back(p);
+                appendEntry(Entry(p));
+                indexId(size()-1);
+                logEdit(size()-1);
+            }
+        }
+    }
+
+    void addParticles(particle_type_type type, const std::vector<Vec3> &positions) override {
+        auto id = Particle::nextIds(positions.size());
+        auto pos = positions.begin();
+        for(; pos != positions.end() && !_blanks.empty(); ++pos, ++id) {
+            const auto idx = _blanks.back();
+            _blanks.pop_back();
+            setEntry(idx, Entry(*pos, type, id));
+            indexId(idx);
+            logEdit(idx);
+        }
+        if(pos != positions.end()) {
+            const auto offset = size();
+            const auto nAppended = static_cast<size_type>(positions.end() - pos);
+            // the fields are appended array by array, each array grows at most once
+            _pos.insert(_pos.end(), pos, positions.end());
+            _force.resize(offset + nAppended, Vec3(0, 0, 0));
+            _type.resize(offset + nAppended, type);
+            _deactivated.resize(offset + nAppended, false);
+            _id.reserve(offset + nAppended);
+            for(; pos != positions.end(); ++pos, ++id) {
+                _id.push_back(id);
+            }
+            _topologyIndex.resize(offset + nAppended, -1);
+            if(nAppended > offset) {
+                // more new entries than old ones, a rebuild is cheaper than processing them edit by edit
+                invalidateEdits();
+            }
+            for(auto idx = offset; idx < size(); ++idx) {
+                indexId(idx);
+                logEdit(idx);
             }
         }
     }
@@ -95,12 +142,14 @@ public:
             if(!_blanks.empty()) {
                 const auto idx = _blanks.back();
                 _blanks.pop_back();
-                _entries.at(idx) = Entry(p);
+                setEntry(idx, Entry(p));
                 indices.push_back(idx);
             } else {
-                _entries.emplace_back(p);
-                indices.push_back(_entries.size()-1);
+                appendEntry(Entry(p));
+                indices.push_back(size()-1);
             }
+            indexId(indices.back());
+            logEdit(indices.back());
         }
         return indices;
     }
@@ -112,7 +161,10 @@ public:
         auto it_del = removedEntries.begin();
         for(auto&& newEntry : newEntries) {
             if(it_del != removedEntries.end()) {
-                _entries.at(*it_del) = std::move(newEntry);
+                unindexId(*it_del);
+                setEntry(*it_del, newEntry);
+                indexId(*it_del);
+                logEdit(*it_del);
                 ++it_del;
             } else {
                 addEntry(std::move(newEntry));
@@ -126,9 +178,10 @@ public:
     }
 
     void displace(size_type index, const Particle::pos_type &delta) override {
-        auto &entry = _entries.at(index);
-        entry.pos += delta;
-        _context.get().fixPositionFun()(entry.pos);
+        auto &pos = _pos.at(index);
+        pos += delta;
+        _context.get().fixPositionFun()(pos);
+        logEdit(index);
     };
 
     void hilbertSort(scalar gridWidth) {
@@ -141,31 +194,35 @@ public:
             std::iota(indices.begin(), indices.end(), 0);
             hilbert_indices.resize(size());
 
-            auto worker = [&](std::size_t, const_iterator begin, const_iterator end, indices_it hilbert_begin) {
-                {
-                    auto it = begin;
-                    auto hilbert_it = hilbert_begin;
-                    for (; it != end; ++it, ++hilbert_it) {
-                        if (!it->deactivated) {
-                            const auto integer_coordinates = project(it->pos, gridWidth);
-                            *hilbert_it = 1 + static_cast<std::size_t>(hilbert_c2i(3, CHAR_BIT, integer_coordinates.data()));
-                        } else {
-                            *hilbert_it = 0;
-                        }
+            // enough bits per dimension to resolve the box, at most 21 so that the curve index fits into 64 bits
+            unsigned nBits = 1;
+            for (auto width : _context.get().boxSize()) {
+                const auto nGridCells = static_cast<unsigned long long>(width / gridWidth) + 1;
+                while (nBits < 21 && (1ULL << nBits) < nGridCells) ++nBits;
+            }
+
+            auto worker = [&](std::size_t, std::size_t begin, std::size_t end, indices_it hilbert_begin) {
+                auto hilbert_it = hilbert_begin;
+                for (auto index = begin; index != end; ++index, ++hilbert_it) {
+                    if (!_deactivated[index]) {
+                        const auto integer_coordinates = project(_pos[index], gridWidth);
+                        *hilbert_it = 1 + static_cast<std::size_t>(hilbert_c2i(3, nBits, integer_coordinates.data()));
+                    } else {
+                        *hilbert_it = 0;
                     }
                 }
             };
             {
                 std::vector<util::thread::joining_future<void>> futures;
                 futures.reserve(_pool.get().size());
-                auto data_it = begin();
+                std::size_t index = 0;
                 auto hilberts_it = hilbert_indices.begin();
                 for (std::size_t i = 0; i < _pool.get().size() - 1; ++i) {
-                    futures.emplace_back(_pool.get().push(worker, data_it, data_it + grainSize, hilberts_it));
-                    data_it += grainSize;
+                    futures.emplace_back(_pool.get().push(worker, index, index + grainSize, hilberts_it));
+                    index += grainSize;
                     hilberts_it += grainSize;
                 }
-                futures.emplace_back(_pool.get().push(worker, data_it, end(), hilberts_it));
+                futures.emplace_back(_pool.get().push(worker, index, size(), hilberts_it));
             }
             {
                 std::sort(indices.begin(), indices.end(),
@@ -174,16 +231,95 @@ public:
                           });
             }
 
-            blanks_moved_to_front();
             std::vector<std::size_t> inverseIndices(indices.size());
             for(std::size_t i = 0; i < indices.size(); ++i) {
                 inverseIndices[indices[i]] = i;
             }
-            reorderSignal->fire_signal(inverseIndices);
-            readdy::util::collections::reorder_destructive(inverseIndices.begin(), inverseIndices.end(), begin());
+            reorder(std::move(inverseIndices));
         }
     };
 
+    /**
+     * Moves the entry at index i to index newIndices[i]. Listeners of the reorder signal are notified beforehand.
+     * @param newIndices the permutation
+     */
+    void reorder(std::vector<std::size_t> &&newIndices) {
+        reorderSignal->fire_signal(newIndices);
+        for (auto &entry : _indexOfId) {
+            entry.second = newIndices[entry.second];
+        }
+        forEachField([&newIndices](auto &field) {
+            // the permutation is consumed by the reordering, so each field gets its own copy
+            auto order = newIndices;
+            readdy::util::collections::reorder_destructive(order.begin(), order.end(), field.begin());
+        });
+        _blanks.clear();
+        for (std::size_t i = 0; i < size(); ++i) {
+            if (_deactivated[i]) {
+                _blanks.push_back(i);
+            }
+        }
+        invalidateEdits();
+    }
+
+    /**
+     * Removes the deactivated entries, the active ones move to the front and keep their relative order. Listeners of
+     * the reorder signal are notified beforehand with the permutation, in which the deactivated entries are moved
+     * behind the active ones (where they are then cut off).
+     */
+    void compact() {
+        if (_blanks.empty()) {
+            return;
+        }
+        const auto nActive = size() - _blanks.size();
+        std::vector<std::size_t> newIndices(size());
+        {
+            std::size_t nextActive = 0;
+            std::size_t nextBlank = nActive;
+            for (std::size_t i = 0; i < size(); ++i) {
+                newIndices[i] = _deactivated[i] ? nextBlank++ : nextActive++;
+            }
+        }
+        reorderSignal->fire_signal(newIndices);
+        for (auto &entry : _indexOfId) {
+            entry.second = newIndices[entry.second];
+        }
+        forEachField([&](auto &field) {
+            // active entries only move towards the front, so they can be moved in place
+            for (std::size_t i = 0; i < field.size(); ++i) {
+                if (newIndices[i] < nActive) {
+                    field[newIndices[i]] = field[i];
+                }
+            }
+            field.resize(nActive);
+        });
+        _blanks.clear();
+        invalidateEdits();
+    }
+
+    /**
+     * @return whether the fraction of deactivated entries exceeds the compaction threshold
+     */
+    bool compactionDue() const {
+        return !_blanks.empty()
+               && static_cast<scalar>(_blanks.size()) > _compactionThreshold * static_cast<scalar>(size());
+    }
+
+    /**
+     * The neighbor list compacts the data (see compact()) before a full rebuild if the fraction of deactivated entries
+     * exceeds this threshold.
+     * @return the threshold, values >= 1 disable compaction
+     */
+    scalar &compactionThreshold() {
+        return _compactionThreshold;
+    }
+
+    const scalar &compactionThreshold() const {
+        return _compactionThreshold;
+    }
+
+private:
+    scalar _compactionThreshold {1};
 };
 
 }
@@ -0,0 +1,87 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * This file is part of ReaDDy.                                     *
+ *                                                                  *
+ * ReaDDy is free software: you can redistribute it and/or modify   *
+ * it under the terms of the GNU Lesser General Public License as   *
+ * published by the Free Software Foundation, either version 3 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU Lesser General Public License for more details.              *
+ *                                                                  *
+ * You should have received a copy of the GNU Lesser General        *
+ * Public License along with this program. If not, see              *
+ * <http://www.gnu.org/licenses/>.                                  *
+ ********************************************************************/
+
+
+/**
+ * Allocator of particle ids that hands out ids from a block reserved at once from the global counter (see
+ * Particle::nextIds()), so that only the reservation of a new block is an atomic operation.
+ *
+ * @file IdBlock.h
+ * @brief Block of particle ids.
+ * @author clonker
+ * @date 09.02.18
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <readdy/model/Particle.h>
+
+namespace readdy {
+namespace kernel {
+namespace cpu {
+namespace data {
+
+class IdBlock {
+public:
+    using id_type = readdy::model::Particle::id_type;
+
+    IdBlock() = default;
+
+    explicit IdBlock(std::size_t blockSize) {
+        reset(blockSize);
+    }
+
+    /**
+     * Discards the ids remaining in the current block, the next id is taken from a fresh block.
+     * @param blockSize the number of ids per block, with a block size of 1 every id is directly taken from the global
+     * counter so that the ids are consecutive in the order of their creation
+     */
+    void reset(std::size_t blockSize) {
+        _blockSize = std::max<std::size_t>(blockSize, 1);
+        _next = _end = 0;
+    }
+
+    /**
+     * @return a new id out of the block
+     */
+    id_type next() {
+        if (_next == _end) {
+            _next = readdy::model::Particle::nextIds(_blockSize);
+            _end = _next + _blockSize;
+        }
+        return _next++;
+    }
+
+    std::size_t blockSize() const {
+        return _blockSize;
+    }
+
+private:
+    std::size_t _blockSize {1};
+    id_type _next {0};
+    id_type _end {0};
+};
+
+}
+}
+}
+}
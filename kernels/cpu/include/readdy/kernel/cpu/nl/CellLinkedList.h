@@ -32,7 +32,10 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <algorithm>
+#include <unordered_map>
 #include <readdy/common/Index.h>
 #include <readdy/model/Context.h>
 #include <readdy/common/Timer.h>
@@ -49,6 +52,21 @@ public:
     using data_type = readdy::kernel::cpu::data::DefaultDataContainer;
     using cell_radius_type = std::uint8_t;
 
+    /**
+     * A cuboid block of cells, given by its lower (inclusive) and upper (exclusive) cell coordinates. In sparse mode,
+     * the occupied cells of the block are additionally listed in the range [cellsBegin, cellsEnd) of the block cells,
+     * see forEachCellInBlock.
+     */
+    struct CellBlock {
+        std::array<std::size_t, 3> begin;
+        std::array<std::size_t, 3> end;
+        std::size_t cellsBegin;
+        std::size_t cellsEnd;
+    };
+    using cell_blocks = std::vector<CellBlock>;
+
+    static constexpr std::uint8_t nColors = 8;
+
     CellLinkedList(data_type &data, const readdy::model::Context &context,
                    thread_pool &pool);
 
@@ -92,6 +110,65 @@ public:
         return _cellNeighborsContent.at(_cellNeighbors(cellIndex, 0_z));
     };
 
+    /**
+     * Periodic image shifts of the adjacent cells, in the same order as neighborsBegin(). Adding the shift to the
+     * position of a particle in the adjacent cell yields its image next to the cell, so that pair differences are
+     * plain subtractions. Only meaningful if imageShiftsResolved().
+     * @param cellIndex the cell
+     * @return pointer to the shift of the first adjacent cell
+     */
+    const Vec3 *neighborShiftsBegin(std::size_t cellIndex) const {
+        return &_cellNeighborShifts.at(_cellNeighbors(cellIndex, 1_z));
+    };
+
+    /**
+     * @return whether each adjacent cell is reached through exactly one periodic image, which is the case if every
+     * periodic axis has at least 2 * radius + 1 cells
+     */
+    bool imageShiftsResolved() const {
+        return _imageShiftsResolved;
+    };
+
+    /**
+     * The adjacent cells are stored in ascending order, the half shell of a cell consists of all adjacent cells with
+     * a larger index. Therefore each pair of adjacent cells is contained in exactly one half shell.
+     * @param cellIndex the cell
+     * @return pointer to the first adjacent cell with a larger index than cellIndex
+     */
+    const std::size_t *halfNeighborsBegin(std::size_t cellIndex) const {
+        return std::upper_bound(neighborsBegin(cellIndex), neighborsEnd(cellIndex), cellIndex);
+    };
+
+    /**
+     * Blocks of cells that can be traversed in parallel with a half-shell stencil, i.e., no two blocks of the same
+     * color have overlapping (half-shell) neighborhoods.
+     * @param color the color, must be smaller than nColors
+     * @return the blocks of that color
+     */
+    const cell_blocks &blocksOfColor(std::uint8_t color) const {
+        return _coloredBlocks.at(color);
+    };
+
+    /**
+     * Invokes the function with the index of each cell of a block, in sparse mode only the occupied ones.
+     */
+    template<typename Function>
+    void forEachCellInBlock(const CellBlock &block, const Function &function) const {
+        if (_sparse) {
+            for (auto it = block.cellsBegin; it != block.cellsEnd; ++it) {
+                function(_blockCells[it]);
+            }
+            return;
+        }
+        for (auto i = block.begin[0]; i < block.end[0]; ++i) {
+            for (auto j = block.begin[1]; j < block.end[1]; ++j) {
+                for (auto k = block.begin[2]; k < block.end[2]; ++k) {
+                    function(_cellIndex(i, j, k));
+                }
+            }
+        }
+    };
+
     data_type &data() {
         return _data.get();
     };
@@ -104,7 +181,10 @@ public:
         return _max_cutoff;
     };
 
-    std::size_t cellOfParticle(std::size_t index) const {
+    /**
+     * @return the index of the particle's cell in the (possibly virtual) grid of cellIndex()
+     */
+    std::size_t gridCellOfParticle(std::size_t index) const {
         const auto &entry = data().entry_at(index);
         if (entry.deactivated) {
             throw std::invalid_argument("requested deactivated entry");
@@ -116,19 +196,108 @@ public:
         return _cellIndex(i, j, k);
     };
 
+    /**
+     * @return the cell of a particle, in sparse mode nCells() if the particle's cell was not occupied at the last
+     * rebuild of the bins
+     */
+    std::size_t cellOfParticle(std::size_t index) const {
+        const auto gridCell = gridCellOfParticle(index);
+        if (_sparse) {
+            const auto it = _slotOfCell.find(gridCell);
+            return it != _slotOfCell.end() ? it->second : nCells();
+        }
+        return gridCell;
+    };
+
     std::size_t nCells() const {
-        return _cellIndex.size();
+        return _sparse ? _cellOfSlot.size() : _cellIndex.size();
+    };
+
+    /**
+     * In sparse mode, the grid given by cellIndex() is not allocated. Instead, the cells that contain particles are
+     * collected at each full rebuild of the bins, and only these are numbered (in ascending grid order), linked with
+     * their occupied adjacent cells, and colored into blocks. Memory and setup time then scale with the number of
+     * particles rather than the volume of the box, which pays off for dilute systems in large boxes. Incremental
+     * edits trigger a full rebuild and the multi-resolution search is not used. Takes effect in setUp().
+     * @return whether the sparse mode is enabled
+     */
+    bool &sparse() {
+        return _sparse;
+    };
+
+    const bool &sparse() const {
+        return _sparse;
+    };
+
+    /**
+     * @param cell a cell index in [0, nCells())
+     * @return its index in the grid of cellIndex()
+     */
+    std::size_t gridCell(std::size_t cell) const {
+        return _sparse ? _cellOfSlot.at(cell) : cell;
+    };
+
+    /**
+     * If positive and smaller than the maximal cutoff, the cells are sized for this cutoff. For each pair of types
+     * that interacts further (see Context::calculateMaxCutoffs), one of the two types is declared large and its
+     * particles are searched over correspondingly more cells. Size-disparate systems then do not pay for their few
+     * large particles. Takes effect in setUp().
+     * @return the small cutoff
+     */
+    scalar &smallCutoff() {
+        return _smallCutoff;
+    };
+
+    const scalar &smallCutoff() const {
+        return _smallCutoff;
+    };
+
+    /**
+     * @return whether the cells are sized for the small cutoff and large types are searched over more cells
+     */
+    bool multiResolution() const {
+        return _multiResolution;
+    };
+
+    bool largeType(particle_type_type type) const {
+        return type < _largeTypes.size() && _largeTypes[type];
     };
 
+    /**
+     * Invokes the function for each cell within the search radius of large particles around a cell, including the
+     * cell itself. Each cell is visited at most once.
+     */
+    template<typename Function>
+    void forEachCellInLargeRange(std::size_t cell, const Function &function) const;
+
 protected:
     virtual void setUpBins(const util::PerformanceNode &node) = 0;
 
+    void setUpColoring(const util::PerformanceNode &node);
+
+    void setUpSparseCells(const util::PerformanceNode &node);
+
+    /**
+     * Collects the occupied cells adjacent to a grid cell in ascending order, excluding the cell itself.
+     */
+    void adjacentSlots(std::size_t gridCell, std::vector<std::size_t> &slots) const;
+
+    Vec3 imageShift(std::size_t cell, std::size_t neighborCell) const;
+
     bool _is_set_up{false};
 
     scalar _skin{0};
     scalar _max_cutoff{0};
     std::uint8_t _radius;
 
+    scalar _smallCutoff{0};
+    scalar _setUpSmallCutoff{0};
+    bool _multiResolution{false};
+    // whether a particle type interacts further than the small cutoff, by type id
+    std::vector<bool> _largeTypes;
+    // number of cells per axis searched around particles of large types
+    std::array<std::size_t, 3> _largeRadius{{1, 1, 1}};
+
     Vec3 _cellSize{0, 0, 0};
 
     util::Index3D _cellIndex;
@@ -136,6 +305,21 @@ protected:
     util::Index2D _cellNeighbors;
     // backing vector of _cellNeighbors index of size (n_cells x (1 + nAdjacentCells))
     std::vector<std::size_t> _cellNeighborsContent;
+    // periodic image shifts of the adjacent cells, same layout as _cellNeighborsContent
+    std::vector<Vec3> _cellNeighborShifts;
+    bool _imageShiftsResolved{false};
+    // blocks of cells grouped by color, see blocksOfColor
+    std::array<cell_blocks, nColors> _coloredBlocks;
+    // cell coordinates at which the blocks start per axis, the last entry is the number of cells of the axis
+    std::array<std::vector<std::size_t>, 3> _blockBoundaries;
+
+    bool _sparse{false};
+    bool _setUpSparse{false};
+    // in sparse mode: the grid cell of each occupied cell (slot) in ascending order, and the reverse mapping
+    std::vector<std::size_t> _cellOfSlot;
+    std::unordered_map<std::size_t, std::size_t> _slotOfCell;
+    // in sparse mode: the occupied cells ordered by block, see CellBlock
+    std::vector<std::size_t> _blockCells;
 
     std::reference_wrapper<data_type> _data;
     std::reference_wrapper<const readdy::model::Context> _context;
@@ -149,7 +333,7 @@ public:
 
     using HEAD = std::vector<util::thread::copyable_atomic<std::size_t>>;
     using LIST = std::vector<std::size_t>;
-    using entry_cref = const data_type::entry_type &;
+    using entry_cref = data_type::const_reference;
     using pair_callback = std::function<void(entry_cref, entry_cref)>;
 
     using iterator_bounds = std::tuple<std::size_t, std::size_t>;
@@ -157,14 +341,56 @@ public:
     CompactCellLinkedList(data_type &data, const readdy::model::Context &context,
                           thread_pool &pool);
 
+    /**
+     * Brings the bins in sync with the particle data. If only single entries were edited since the last update (e.g.,
+     * by reactions, see DataContainer::edits()), these are unlinked from their old cell and inserted into their new
+     * one. Otherwise all particles are rebinned.
+     */
     void update(const util::PerformanceNode &node) override {
         auto t = node.timeit();
-        setUpBins(node.subnode("setUpBins"));
+        if (_binsValid && _data.get().editsComplete()) {
+            if (!_data.get().edits().empty()) {
+                if (_sparse) {
+                    // edited particles may occupy cells that are not materialized
+                    setUpBins(node.subnode("setUpBins"));
+                } else {
+                    applyEdits(node.subnode("applyEdits"));
+                }
+                ++_generation;
+            }
+        } else if (_verlet) {
+            // the positions changed even if the lists are reused
+            ++_generation;
+            if (!_verletValid || displacedTooFar(node.subnode("check displacements"))) {
+                _verletValid = false;
+                setUpBins(node.subnode("setUpBins"));
+                setUpVerletList(node.subnode("setUpVerletList"));
+            }
+        } else {
+            _verletValid = false;
+            setUpBins(node.subnode("setUpBins"));
+        }
     };
 
     void clear() override {
         _head.resize(0);
         _list.resize(0);
+        _binOf.resize(0);
+        _large.resize(0);
+        _largeHead.resize(0);
+        _largeList.resize(0);
+        _binsValid = false;
+        _contiguous = false;
+        _verletValid = false;
+        ++_generation;
+    };
+
+    /**
+     * @return a counter that changes whenever update() or a rebuild of the bins may have changed the particle
+     * positions or the binning, it stays the same if the particle data was not touched since the previous update
+     */
+    std::size_t generation() const {
+        return _generation;
     };
 
     BoxIterator particlesBegin(std::size_t cellIndex);
@@ -191,14 +417,134 @@ public:
         return _serial;
     };
 
+    /**
+     * In Verlet mode, the bins and the per-particle half neighbor lists (containing all pairs within cutoff + skin)
+     * are only rebuilt in update() if a particle moved further than skin/2 since the last build or if particles were
+     * added, removed, or reordered. Otherwise the cached lists are reused, they still contain all pairs within the
+     * cutoff. Incremental edits of the bins discard the cached lists until the next rebuild.
+     * @return whether the Verlet mode is enabled
+     */
+    bool &verlet() {
+        return _verlet;
+    };
+
+    const bool &verlet() const {
+        return _verlet;
+    };
+
+    /**
+     * The particle data is reordered along a Hilbert curve (see DefaultDataContainer::hilbertSort) before every n-th
+     * full rebuild of the bins, 0 disables the periodic reordering.
+     * @return the interval n
+     */
+    std::uint32_t &hilbertSortInterval() {
+        return _hilbertSortInterval;
+    };
+
+    const std::uint32_t &hilbertSortInterval() const {
+        return _hilbertSortInterval;
+    };
+
+    /**
+     * The particle data is also reordered before a full rebuild of the bins if, at the previous rebuild, the fraction
+     * of particles that are contained in a different cell than their predecessor in memory exceeded this threshold.
+     * @return the threshold, values >= 1 disable the heuristic
+     */
+    scalar &hilbertSortThreshold() {
+        return _hilbertSortThreshold;
+    };
+
+    const scalar &hilbertSortThreshold() const {
+        return _hilbertSortThreshold;
+    };
+
+    /**
+     * If enabled, every full rebuild of the bins reorders the particle data by cell, so that the particles of each
+     * cell occupy a contiguous range of indices (i.e., cellContents() is the identity) and neighbor traversal streams
+     * through memory. The reorder signal of the data container is fired.
+     * @return whether sorting by cell is enabled
+     */
+    bool &sortByCell() {
+        return _sortByCell;
+    };
+
+    const bool &sortByCell() const {
+        return _sortByCell;
+    };
+
+    /**
+     * @return whether the particles of each cell are currently stored in cellContents() in the range
+     * [cellBegin(cell), cellEnd(cell)) in ascending order, this holds after a parallel rebuild until the bins are
+     * edited incrementally
+     */
+    bool contiguous() const {
+        return _contiguous;
+    };
+
+    const std::vector<std::size_t> &cellContents() const {
+        return _cellContents;
+    };
+
+    std::size_t cellBegin(std::size_t cellIndex) const {
+        return _cellOffsets[cellIndex];
+    };
+
+    std::size_t cellEnd(std::size_t cellIndex) const {
+        return _cellOffsets[cellIndex + 1];
+    };
+
+    /**
+     * @return whether the cached Verlet lists are currently used by forEachHalfNeighbor
+     */
+    bool verletValid() const {
+        return _verletValid;
+    };
+
     template<typename Function>
     void forEachNeighbor(std::size_t particle, const Function &function) const {
-        forEachNeighbor(particle, cellOfParticle(particle), function);
+        const auto cell = cellOfParticle(particle);
+        if (cell == nCells()) {
+            // in sparse mode the particle may have moved into a cell that is not materialized
+            std::vector<std::size_t> slots;
+            adjacentSlots(gridCellOfParticle(particle), slots);
+            for (auto slot : slots) {
+                std::for_each(particlesBegin(slot), particlesEnd(slot), [&](std::size_t neighbor) {
+                    if (neighbor != particle) function(neighbor);
+                });
+            }
+            return;
+        }
+        forEachNeighbor(particle, cell, function);
     }
 
     template<typename Function>
     void forEachNeighbor(std::size_t particle, std::size_t cell, const Function &function) const;
 
+    /**
+     * Visits the neighbors of a particle in its half shell, i.e., the particles that come after it in its own cell and
+     * the particles in adjacent cells with larger cell index. Iterating over all particles of all cells in this way
+     * yields each pair exactly once. In Verlet mode, only the half shell neighbors within cutoff + skin at the time
+     * of the last build are visited. In multi-resolution mode, pairs involving a particle of large type are instead
+     * visited from the large particle, which searches all cells within its larger range.
+     */
+    template<typename Function>
+    void forEachHalfNeighbor(const BoxIterator &particle, std::size_t cell, const Function &function) const;
+
+    /**
+     * @return whether forEachHalfNeighborShifted can currently be used, i.e., the image shifts are resolved and
+     * neither Verlet lists nor the multi-resolution search are in use
+     */
+    bool imageShiftsAvailable() const {
+        return _imageShiftsResolved && !_verletValid && !_multiResolution;
+    };
+
+    /**
+     * Visits the same neighbors as forEachHalfNeighbor, but the function additionally receives the periodic image
+     * shift of the neighbor's cell (see neighborShiftsBegin). Requires imageShiftsAvailable().
+     */
+    template<typename Function>
+    void forEachHalfNeighborShifted(const BoxIterator &particle, std::size_t cell, const Function &function) const;
+
     bool cellEmpty(std::size_t index) const {
         return (*_head.at(index)).load() == 0;
     };
@@ -208,12 +554,74 @@ protected:
     template<bool serial>
     void fillBins(const util::PerformanceNode &node);
 
+    void countingSort(const util::PerformanceNode &node);
+
+    void linkCellContents(const util::PerformanceNode &node);
+
+    void fillSortedBins(const util::PerformanceNode &node);
+
+    bool displacedTooFar(const util::PerformanceNode &node) const;
+
+    void applyEdits(const util::PerformanceNode &node);
+
+    void unlink(std::size_t index);
+
+    void setUpLargeParticles(const util::PerformanceNode &node);
+
+    void linkLarge(std::size_t index, std::size_t cell);
+
+    void unlinkLarge(std::size_t index);
+
+    bool hilbertSortDue() const;
+
+    scalar scatter() const;
+
+    void setUpVerletList(const util::PerformanceNode &node);
+
+    std::size_t _generation{0};
+
     HEAD _head;
     // particles, 1-indexed
     LIST _list;
+    // the cell each particle is linked into (0-indexed), nCells() if it is not contained in any
+    std::vector<std::size_t> _binOf;
+    bool _binsValid{false};
+
+    bool _sortByCell{false};
+    bool _contiguous{false};
+    // if _contiguous, the particles of cell i are _cellContents[_cellOffsets[i]] to _cellContents[_cellOffsets[i+1]-1]
+    std::vector<std::size_t> _cellOffsets;
+    std::vector<std::size_t> _cellContents;
+    // per chunk of particles counts and then offsets per cell, see countingSort
+    std::vector<std::size_t> _histograms;
+
+    // in multi-resolution mode: whether a particle is of a large type, and the large particles of each cell, 1-indexed
+    std::vector<bool> _large;
+    std::vector<std::size_t> _largeHead;
+    LIST _largeList;
+
+    std::uint32_t _hilbertSortInterval{0};
+    scalar _hilbertSortThreshold{1};
+    std::uint32_t _binsSinceSort{0};
+    // fraction of particles in a different cell than their predecessor in memory, measured at the last rebuild
+    scalar _scatter{0};
 
     bool _serial{false};
 
+    struct VerletReference {
+        Vec3 pos;
+        data_type::entry_type::Particle::id_type id;
+        particle_type_type type;
+        bool deactivated;
+    };
+
+    bool _verlet{false};
+    bool _verletValid{false};
+    // half neighbors within cutoff + skin per particle index, valid if _verletValid
+    std::vector<std::vector<std::size_t>> _verletList;
+    // state of the particles when the Verlet lists were built
+    std::vector<VerletReference> _verletReference;
+
 };
 
 class BoxIterator {
@@ -292,9 +700,72 @@ inline BoxIterator CompactCellLinkedList::particlesEnd(std::size_t /*cellIndex*/
 }
 
 
+template<typename Function>
+inline void CellLinkedList::forEachCellInLargeRange(std::size_t cell, const Function &function) const {
+    const auto &pbc = _context.get().periodicBoundaryConditions();
+    const auto center = _cellIndex.inverse(cell);
+    std::array<std::ptrdiff_t, 3> begin{}, end{}, n{};
+    for (int d = 0; d < 3; ++d) {
+        n[d] = static_cast<std::ptrdiff_t>(_cellIndex[d]);
+        const auto r = static_cast<std::ptrdiff_t>(_largeRadius[d]);
+        const auto c = static_cast<std::ptrdiff_t>(center[d]);
+        if (pbc[d] && 2 * r + 1 < n[d]) {
+            begin[d] = c - r;
+            end[d] = c + r + 1;
+        } else if (pbc[d]) {
+            // the stencil wraps around onto itself, each cell along the axis is within range
+            begin[d] = 0;
+            end[d] = n[d];
+        } else {
+            begin[d] = std::max(c - r, static_cast<std::ptrdiff_t>(0));
+            end[d] = std::min(c + r + 1, n[d]);
+        }
+    }
+    auto wrap = [](std::ptrdiff_t x, std::ptrdiff_t nx) { return static_cast<std::size_t>((x % nx + nx) % nx); };
+    for (auto i = begin[0]; i < end[0]; ++i) {
+        for (auto j = begin[1]; j < end[1]; ++j) {
+            for (auto k = begin[2]; k < end[2]; ++k) {
+                function(_cellIndex(wrap(i, n[0]), wrap(j, n[1]), wrap(k, n[2])));
+            }
+        }
+    }
+}
+
 template<typename Function>
 inline void CompactCellLinkedList::forEachNeighbor(std::size_t particle, std::size_t cell,
                                                    const Function &function) const {
+    if (_multiResolution) {
+        if (_large[particle]) {
+            forEachCellInLargeRange(cell, [&](std::size_t c) {
+                std::for_each(particlesBegin(c), particlesEnd(c), [&](std::size_t neighbor) {
+                    if (neighbor != particle) function(neighbor);
+                });
+            });
+        } else {
+            // small neighbors within the regular stencil, large neighbors within the large one
+            auto small = [&](std::size_t neighbor) {
+                if (neighbor != particle && !_large[neighbor]) function(neighbor);
+            };
+            std::for_each(particlesBegin(cell), particlesEnd(cell), small);
+            for (auto itNeighCell = neighborsBegin(cell); itNeighCell != neighborsEnd(cell); ++itNeighCell) {
+                std::for_each(particlesBegin(*itNeighCell), particlesEnd(*itNeighCell), small);
+            }
+            forEachCellInLargeRange(cell, [&](std::size_t c) {
+                std::for_each(BoxIterator(_largeList, _largeHead[c]), BoxIterator(_largeList, 0), function);
+            });
+        }
+        return;
+    }
+    if (_contiguous) {
+        const auto contents = _cellContents.data();
+        std::for_each(contents + cellBegin(cell), contents + cellEnd(cell), [&function, particle](auto x) {
+            if (x != particle) function(x);
+        });
+        for (auto itNeighCell = neighborsBegin(cell); itNeighCell != neighborsEnd(cell); ++itNeighCell) {
+            std::for_each(contents + cellBegin(*itNeighCell), contents + cellEnd(*itNeighCell), function);
+        }
+        return;
+    }
     std::for_each(particlesBegin(cell), particlesEnd(cell), [&function, particle](auto x) {
         if (x != particle) function(x);
     });
@@ -303,6 +774,74 @@ inline void CompactCellLinkedList::forEachNeighbor(std::size_t particle, std::si
     }
 }
 
+template<typename Function>
+inline void CompactCellLinkedList::forEachHalfNeighbor(const BoxIterator &particle, std::size_t cell,
+                                                       const Function &function) const {
+    if (_verletValid) {
+        const auto &neighbors = _verletList[*particle];
+        std::for_each(neighbors.begin(), neighbors.end(), function);
+        return;
+    }
+    if (_multiResolution) {
+        const auto index = *particle;
+        if (_large[index]) {
+            // pairs with a large particle are visited from its side, pairs of two large ones by the smaller index
+            forEachCellInLargeRange(cell, [&](std::size_t c) {
+                std::for_each(particlesBegin(c), particlesEnd(c), [&](std::size_t neighbor) {
+                    if (neighbor != index && (!_large[neighbor] || neighbor > index)) function(neighbor);
+                });
+            });
+        } else {
+            auto small = [&](std::size_t neighbor) {
+                if (!_large[neighbor]) function(neighbor);
+            };
+            std::for_each(std::next(particle, 1), particlesEnd(cell), small);
+            for (auto itNeighCell = halfNeighborsBegin(cell); itNeighCell != neighborsEnd(cell); ++itNeighCell) {
+                std::for_each(particlesBegin(*itNeighCell), particlesEnd(*itNeighCell), small);
+            }
+        }
+        return;
+    }
+    if (_contiguous) {
+        // the contents of a cell are in ascending order, the same order as the linked list
+        const auto contents = _cellContents.data();
+        std::for_each(std::upper_bound(contents + cellBegin(cell), contents + cellEnd(cell), *particle),
+                      contents + cellEnd(cell), function);
+        for (auto itNeighCell = halfNeighborsBegin(cell); itNeighCell != neighborsEnd(cell); ++itNeighCell) {
+            std::for_each(contents + cellBegin(*itNeighCell), contents + cellEnd(*itNeighCell), function);
+        }
+        return;
+    }
+    std::for_each(std::next(particle, 1), particlesEnd(cell), function);
+    for (auto itNeighCell = halfNeighborsBegin(cell); itNeighCell != neighborsEnd(cell); ++itNeighCell) {
+        std::for_each(particlesBegin(*itNeighCell), particlesEnd(*itNeighCell), function);
+    }
+}
+
+template<typename Function>
+inline void CompactCellLinkedList::forEachHalfNeighborShifted(const BoxIterator &particle, std::size_t cell,
+                                                              const Function &function) const {
+    const Vec3 noShift{0, 0, 0};
+    auto itShift = neighborShiftsBegin(cell) + (halfNeighborsBegin(cell) - neighborsBegin(cell));
+    if (_contiguous) {
+        const auto contents = _cellContents.data();
+        std::for_each(std::upper_bound(contents + cellBegin(cell), contents + cellEnd(cell), *particle),
+                      contents + cellEnd(cell), [&](std::size_t neighbor) { function(neighbor, noShift); });
+        for (auto itNeighCell = halfNeighborsBegin(cell); itNeighCell != neighborsEnd(cell); ++itNeighCell, ++itShift) {
+            const auto &shift = *itShift;
+            std::for_each(contents + cellBegin(*itNeighCell), contents + cellEnd(*itNeighCell),
+                          [&](std::size_t neighbor) { function(neighbor, shift); });
+        }
+        return;
+    }
+    std::for_each(std::next(particle, 1), particlesEnd(cell), [&](std::size_t neighbor) { function(neighbor, noShift); });
+    for (auto itNeighCell = halfNeighborsBegin(cell); itNeighCell != neighborsEnd(cell); ++itNeighCell, ++itShift) {
+        const auto &shift = *itShift;
+        std::for_each(particlesBegin(*itNeighCell), particlesEnd(*itNeighCell),
+                      [&](std::size_t neighbor) { function(neighbor, shift); });
+    }
+}
+
 }
 }
 }
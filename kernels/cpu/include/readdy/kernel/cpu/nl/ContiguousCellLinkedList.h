@@ -102,6 +102,14 @@ public:
         }
     }
 
+    template<typename Function>
+    void forEachHalfNeighbor(const std::size_t *particle, std::size_t cell, const Function &function) const {
+        std::for_each(particle + 1, particlesEnd(cell), function);
+        for(auto itNeighCell = halfNeighborsBegin(cell); itNeighCell != neighborsEnd(cell); ++itNeighCell) {
+            std::for_each(particlesBegin(*itNeighCell), particlesEnd(*itNeighCell), function);
+        }
+    }
+
 protected:
 
     void setUpBins(const util::PerformanceNode &node) override { };
@@ -0,0 +1,144 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * This file is part of ReaDDy.                                     *
+ *                                                                  *
+ * ReaDDy is free software: you can redistribute it and/or modify   *
+ * it under the terms of the GNU Lesser General Public License as   *
+ * published by the Free Software Foundation, either version 3 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU Lesser General Public License for more details.              *
+ *                                                                  *
+ * You should have received a copy of the GNU Lesser General        *
+ * Public License along with this program. If not, see              *
+ * <http://www.gnu.org/licenses/>.                                  *
+ ********************************************************************/
+
+
+
+
+/**
+ * List of the particle pairs within the maximal cutoff, collected from the compact cell linked list. It is built at
+ * most once per neighbor list update and then shared by the force calculation and the reaction handlers, which
+ * otherwise each traverse the cells and compute the same distances. The pairs are grouped by the colored cell blocks
+ * of the neighbor list (see CellLinkedList::blocksOfColor), so that the pairs of blocks with the same color can still
+ * be processed concurrently.
+ *
+ * @file PairList.h
+ * @brief Cached list of interacting particle pairs, shared by forces and reactions.
+ * @author clonker
+ * @date 14.02.18
+ */
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <readdy/common/common.h>
+#include <readdy/common/ReaDDyVec3.h>
+#include <readdy/kernel/cpu/nl/CellLinkedList.h>
+
+namespace readdy {
+namespace kernel {
+namespace cpu {
+namespace nl {
+
+class PairList {
+public:
+    /**
+     * A pair of particle indices together with their minimum image difference x_ij = pos_j - pos_i and its squared
+     * norm.
+     */
+    struct Pair {
+        std::size_t i;
+        std::size_t j;
+        scalar distSquared;
+        Vec3 x_ij;
+    };
+    using pairs = std::vector<Pair>;
+
+    PairList(const CompactCellLinkedList &neighborList, const model::Context &context, thread_pool &pool);
+
+    /**
+     * @return whether the pair list is used by the forces and reactions, disabled by default
+     */
+    bool &enabled() {
+        return _enabled;
+    };
+
+    const bool &enabled() const {
+        return _enabled;
+    };
+
+    /**
+     * Collects the pairs anew if the neighbor list changed since the last build. Only pairs of active particles
+     * whose types interact by a second order potential or reaction are contained.
+     * @param node perf node
+     */
+    void update(const util::PerformanceNode &node);
+
+    /**
+     * The pairs are filtered by the types at the time they were collected. Type changes are logged as edits of the
+     * particle data (see DataContainer::setType()), which advance the generation of the neighbor list, so that the
+     * pairs are collected anew after conversions.
+     * @return whether the pairs reflect the current state of the neighbor list
+     */
+    bool upToDate() const {
+        return _built && _generation == _neighborList.get().generation();
+    };
+
+    /**
+     * The pairs of the blocks of a color, in the same order as the blocks.
+     * @param color the color, must be smaller than CellLinkedList::nColors
+     * @return pointer to the pairs of the first block of that color
+     */
+    const pairs *colorBegin(std::uint8_t color) const {
+        return _blockPairs.data() + _colorOffsets[color];
+    };
+
+    const pairs *colorEnd(std::uint8_t color) const {
+        return _blockPairs.data() + _colorOffsets[color + 1];
+    };
+
+    /**
+     * @return the pairs of all blocks of all colors
+     */
+    const std::vector<pairs> &blockPairs() const {
+        return _blockPairs;
+    };
+
+    std::size_t size() const;
+
+    template<typename Function>
+    void forEachPair(const Function &function) const {
+        for (const auto &block : _blockPairs) {
+            for (const auto &pair : block) {
+                function(pair);
+            }
+        }
+    };
+
+private:
+    std::reference_wrapper<const CompactCellLinkedList> _neighborList;
+    std::reference_wrapper<const model::Context> _context;
+    std::reference_wrapper<thread_pool> _pool;
+
+    bool _enabled{false};
+    bool _built{false};
+    std::size_t _generation{0};
+
+    // whether a pair of types (row-major) interacts by a second order potential or reaction
+    std::vector<char> _interacting;
+    std::vector<pairs> _blockPairs;
+    std::array<std::size_t, CellLinkedList::nColors + 1> _colorOffsets{};
+};
+
+}
+}
+}
+}
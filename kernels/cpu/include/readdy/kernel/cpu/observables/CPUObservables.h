@@ -31,6 +31,7 @@
 
 #pragma once
 #include <readdy/model/observables/Observables.h>
+#include <readdy/kernel/cpu/Reduction.h>
 
 namespace readdy {
 namespace kernel {
@@ -82,6 +83,7 @@ public:
 protected:
     CPUKernel *const kernel;
     size_t size;
+    Reduction<result_type> histograms;
 };
 
 class CPUNParticles : public readdy::model::observables::NParticles {
@@ -29,6 +29,9 @@
  * @date 12/11/17
  */
 
+#include <chrono>
+#include <limits>
+#include <unordered_map>
 #include <readdy/kernel/cpu/CPUKernel.h>
 
 
@@ -68,6 +71,94 @@ void CPUKernel::initialize() {
     _stateModel.virial() = Matrix33{{{0, 0, 0, 0, 0, 0, 0, 0, 0}}};
 }
 
+void CPUKernel::tune(scalar timeStep, const util::PerformanceNode &node) {
+    auto &configuration = _context.kernelConfiguration().cpu.neighborList;
+    if (!configuration.auto_tune) return;
+    auto t = node.timeit();
+    initialize();
+    configuration.auto_tune = false;
+
+    const auto maxCutoff = _context.calculateMaxCutoff();
+    if (maxCutoff <= 0 || _data.size() == _data.getNDeactivated()) {
+        log::debug("nothing to tune, there are no interactions or no particles");
+        return;
+    }
+
+    // the trial steps move the particles, they are put back afterwards. The random numbers they consume are not, the
+    // generators are thread-local and cannot be saved and restored from here.
+    std::unordered_map<readdy::model::Particle::id_type, Vec3> positions;
+    for (const auto &entry : _data) {
+        if (!entry.deactivated) {
+            positions.emplace(entry.id, entry.pos);
+        }
+    }
+
+    struct Candidate {
+        std::uint8_t radius;
+        scalar skin;
+        bool verlet;
+    };
+    std::vector<Candidate> candidates;
+    for (std::uint8_t radius = 1; radius <= 3; ++radius) {
+        candidates.push_back({radius, 0, false});
+    }
+    for (auto skinFraction : {static_cast<scalar>(.1), static_cast<scalar>(.25)}) {
+        for (std::uint8_t radius = 1; radius <= 2; ++radius) {
+            candidates.push_back({radius, skinFraction * maxCutoff, true});
+        }
+    }
+
+    auto integrator = _actions.eulerBDIntegrator(timeStep);
+    auto forces = _actions.calculateForces();
+    const auto describe = [](const Candidate &candidate) {
+        return fmt::format("cll_radius={}, skin={}, verlet={}", static_cast<int>(candidate.radius), candidate.skin,
+                           candidate.verlet);
+    };
+
+    auto best = candidates.front();
+    auto bestTime = std::numeric_limits<double>::infinity();
+    for (const auto &candidate : candidates) {
+        configuration.cll_radius = candidate.radius;
+        configuration.skin = candidate.skin;
+        configuration.verlet = candidate.verlet;
+        _stateModel.configure(_context.kernelConfiguration().cpu);
+
+        const auto &candidateNode = node.subnode(describe(candidate));
+        const auto begin = std::chrono::high_resolution_clock::now();
+        {
+            auto tCandidate = candidateNode.timeit();
+            _stateModel.initializeNeighborList(0, candidateNode.subnode("initNeighborList"));
+            forces->perform(candidateNode.subnode("forces"));
+            for (std::uint32_t step = 0; step < configuration.auto_tune_steps; ++step) {
+                integrator->perform(candidateNode.subnode("integrator"));
+                _stateModel.updateNeighborList(candidateNode.subnode("neighborList"));
+                forces->perform(candidateNode.subnode("forces"));
+            }
+        }
+        const auto elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+        log::debug("neighbor list candidate {} took {} s", describe(candidate), elapsed);
+        if (elapsed < bestTime) {
+            bestTime = elapsed;
+            best = candidate;
+        }
+
+        _stateModel.clearNeighborList();
+        for (auto entry : _data) {
+            if (!entry.deactivated) {
+                entry.pos = positions.at(entry.id);
+            }
+        }
+        _data.invalidateEdits();
+    }
+
+    configuration.cll_radius = best.radius;
+    configuration.skin = best.skin;
+    configuration.verlet = best.verlet;
+    _stateModel.configure(_context.kernelConfiguration().cpu);
+    log::info("selected neighbor list configuration {}", describe(best));
+}
+
+
 }
 }
 }
@@ -67,11 +67,23 @@ const std::vector<readdy::model::Particle> CPUStateModel::getParticles() const {
     return result;
 }
 
+std::vector<readdy::model::Particle>
+CPUStateModel::getParticlesForIds(const std::vector<readdy::model::Particle::id_type> &ids) const {
+    const auto &data = _data.get();
+    std::vector<readdy::model::Particle> result;
+    result.reserve(ids.size());
+    for (auto index : data.getIndicesForIds(ids)) {
+        result.push_back(data.getParticle(index));
+    }
+    return result;
+}
+
 CPUStateModel::CPUStateModel(data_type &data, const readdy::model::Context &context,
                              thread_pool &pool,
                              readdy::model::top::TopologyActionFactory const *const taf)
         : _pool(pool), _context(context), _topologyActionFactory(*taf), _data(data) {
     _neighborList = std::make_unique<neighbor_list>(_data.get(), _context.get(), _pool.get());
+    _pairList = std::make_unique<pair_list>(*_neighborList, _context.get(), _pool.get());
     _reorderConnection = std::make_unique<readdy::signals::scoped_connection>(
             getParticleData()->registerReorderEventListener([this](const std::vector<std::size_t> &indices) -> void {
                 for (auto &top : _topologies) {
@@ -27,6 +27,7 @@
  */
 
 #include "readdy/kernel/cpu/actions/CPUCalculateForces.h"
+#include "readdy/kernel/cpu/actions/NeighborLanes.h"
 
 namespace readdy {
 namespace kernel {
@@ -51,52 +52,62 @@ void CPUCalculateForces::perform(const util::PerformanceNode &node) {
     const auto &potOrder2 = ctx.potentials().potentialsOrder2();
     if (!potOrder1.empty() || !potOrder2.empty() || !stateModel.topologies().empty()) {
         {
-            // todo maybe optimize this by transposing data structure
+            // only particles that can feel a force are cleared and visited by the order 1 tasks
             auto tClear = node.subnode("clear forces").timeit();
-            std::for_each(data->begin(), data->end(), [](auto &entry) {
-                entry.force = {0, 0, 0};
-            });
+            const auto &potentials = ctx.potentials();
+            _active.clear();
+            auto &forces = data->forces();
+            const auto &types = data->types();
+            const auto &deactivated = data->deactivated();
+            for (std::size_t index = 0; index < data->size(); ++index) {
+                if (deactivated[index]) continue;
+                auto &force = forces[index];
+                if (potentials.interacting(types[index])) {
+                    force = {0, 0, 0};
+                    _active.push_back(index);
+                } else if (force != Vec3{0, 0, 0}) {
+                    // left over from before the particle changed its type
+                    force = {0, 0, 0};
+                }
+            }
         }
         {
             auto &pool = data->pool();
-            std::vector<std::promise<scalar>> promises;
-            std::vector<std::promise<Matrix33>> virialPromises;
-            // 1st order pot + topologies = 2*pool size
-            // 2nd order pot <= nl.nCells
             size_t nThreads = pool.size();
-            auto numberTasks = (!potOrder1.empty() ? nThreads : 0)
-                               + (!potOrder2.empty() ? nThreads : 0)
-                               + (!topologies.empty() ? nThreads : 0);
+            // the tasks accumulate into the slot of the thread they are executed on
+            _energies.reset(nThreads, 0);
+            _virials.reset(nThreads, virial_type{});
             {
                 const auto &nTasks = node.subnode("create tasks");
                 auto tTasks = nTasks.timeit();
-                size_t nCells = neighborList->nCells();
-                promises.reserve(numberTasks);
-                virialPromises.reserve(!potOrder2.empty() ? nThreads : 0);
                 if (!potOrder1.empty()) {
                     // 1st order pot
                     auto tO1 = nTasks.subnode("order1").timeit();
+                    _buckets.resize(nThreads);
+                    for (auto &buckets : _buckets) {
+                        buckets.resize(ctx.potentials().tableOrder1().nTypes());
+                    }
                     std::vector<std::function<void(std::size_t)>> tasks;
                     tasks.reserve(nThreads);
 
-                    const std::size_t grainSize = data->size() / nThreads;
-                    auto it = data->begin();
+                    const std::size_t grainSize = _active.size() / nThreads;
+                    const auto *it = _active.data();
+                    const auto *end = _active.data() + _active.size();
                     for (auto i = 0_z; i < nThreads - 1; ++i) {
-                        auto itNext = std::min(it + grainSize, data->end());
+                        auto itNext = it + grainSize;
                         if (it != itNext) {
-                            promises.emplace_back();
-                            auto dataBounds = std::make_tuple(it, itNext);
-                            tasks.push_back(pool.pack(calculate_order1, dataBounds, std::ref(promises.back()), data,
-                                                      ctx.potentials().potentialsOrder1(),
-                                                      ctx.shortestDifferenceFun()));
+                            auto bounds = std::make_tuple(it, itNext);
+                            tasks.push_back(pool.pack(calculate_order1, bounds, std::ref(_energies), data,
+                                                      std::cref(ctx.potentials().tableOrder1()),
+                                                      std::ref(_buckets)));
                         }
                         it = itNext;
                     }
-                    if (it != data->end()) {
-                        promises.emplace_back();
-                        auto dataBounds = std::make_tuple(it, data->end());
-                        tasks.push_back(pool.pack(calculate_order1, dataBounds, std::ref(promises.back()), data,
-                                                  ctx.potentials().potentialsOrder1(), ctx.shortestDifferenceFun()));
+                    if (it != end) {
+                        auto bounds = std::make_tuple(it, end);
+                        tasks.push_back(pool.pack(calculate_order1, bounds, std::ref(_energies), data,
+                                                  std::cref(ctx.potentials().tableOrder1()),
+                                                  std::ref(_buckets)));
                     }
                     {
                         auto tPush = nTasks.subnode("execute order 1 tasks and wait").timeit();
@@ -117,17 +128,14 @@ void CPUCalculateForces::perform(const util::PerformanceNode &node) {
                     for (auto i = 0_z; i < nThreads - 1; ++i) {
                         auto itNext = std::min(it + grainSize, topologies.cend());
                         if (it != itNext) {
-                            promises.emplace_back();
                             auto bounds = std::make_tuple(it, itNext);
-                            tasks.push_back(
-                                    pool.pack(calculate_topologies, bounds, taf, std::ref(promises.back())));
+                            tasks.push_back(pool.pack(calculate_topologies, bounds, taf, std::ref(_energies)));
                         }
                         it = itNext;
                     }
                     if (it != topologies.cend()) {
-                        promises.emplace_back();
                         auto bounds = std::make_tuple(it, topologies.cend());
-                        tasks.push_back(pool.pack(calculate_topologies, bounds, taf, std::ref(promises.back())));
+                        tasks.push_back(pool.pack(calculate_topologies, bounds, taf, std::ref(_energies)));
                     }
                     {
                         auto tPush = nTasks.subnode("execute topology tasks and wait").timeit();
@@ -141,73 +149,84 @@ void CPUCalculateForces::perform(const util::PerformanceNode &node) {
                 }
                 if (!potOrder2.empty()) {
                     auto tO2 = nTasks.subnode("order2").timeit();
-                    std::vector<std::function<void(std::size_t)>> tasks;
-                    tasks.reserve(nThreads);
-                    auto granularity = nThreads;
-                    const std::size_t grainSize = nCells / granularity;
-                    auto it = 0_z;
-                    for (auto i = 0_z; i < granularity - 1; ++i) {
-                        auto itNext = std::min(it + grainSize, nCells);
-                        if (it != itNext) {
-                            promises.emplace_back();
-                            virialPromises.emplace_back();
-                            if(ctx.recordVirial()) {
-                                tasks.push_back(pool.pack(
-                                        calculate_order2<true>, std::make_tuple(it, itNext), data,
-                                        std::cref(*neighborList), std::ref(promises.back()),
-                                        std::ref(virialPromises.back()), ctx.potentials().potentialsOrder2(),
-                                        ctx.shortestDifferenceFun()
-                                ));
-                            } else {
-                                tasks.push_back(pool.pack(
-                                        calculate_order2<false>, std::make_tuple(it, itNext), data,
-                                        std::cref(*neighborList), std::ref(promises.back()),
-                                        std::ref(virialPromises.back()), ctx.potentials().potentialsOrder2(),
-                                        ctx.shortestDifferenceFun()
-                                ));
-                            }
-                        }
-                        it = itNext;
+                    // Each pair is evaluated once and its force is applied to both particles. Blocks of cells with
+                    // the same color can be processed concurrently, the colors themselves are processed one after
+                    // another.
+                    // If enabled, the pair list contains the same pairs grouped by the same blocks.
+                    const auto &pairList = stateModel.pairList();
+                    if (pairList.enabled()) {
+                        stateModel.updatePairList(nTasks.subnode("update pair list"));
                     }
-                    if (it != nCells) {
-                        promises.emplace_back();
-                        virialPromises.emplace_back();
-                        if(ctx.recordVirial()) {
-                            tasks.push_back(pool.pack(
-                                    calculate_order2<true>, std::make_tuple(it, nCells), data, std::cref(*neighborList),
-                                    std::ref(promises.back()), std::ref(virialPromises.back()),
-                                    ctx.potentials().potentialsOrder2(), ctx.shortestDifferenceFun()
-                            ));
+                    for (std::uint8_t color = 0; color < nl::CellLinkedList::nColors; ++color) {
+                        const auto &blocks = neighborList->blocksOfColor(color);
+                        if (blocks.empty()) continue;
+                        std::vector<std::function<void(std::size_t)>> tasks;
+                        tasks.reserve(nThreads);
+                        const std::size_t nTasksColor = std::min(nThreads, blocks.size());
+                        const std::size_t grainSize = blocks.size() / nTasksColor;
+                        if (pairList.enabled()) {
+                            auto it = pairList.colorBegin(color);
+                            const auto end = pairList.colorEnd(color);
+                            for (auto i = 0_z; i < nTasksColor; ++i) {
+                                auto itNext = i == nTasksColor - 1 ? end : it + grainSize;
+                                if (ctx.recordVirial()) {
+                                    tasks.push_back(pool.pack(
+                                            calculate_order2_pairs<true>, std::make_tuple(it, itNext), data,
+                                            std::ref(_energies), std::ref(_virials),
+                                            std::cref(ctx.potentials().tableOrder2())
+                                    ));
+                                } else {
+                                    tasks.push_back(pool.pack(
+                                            calculate_order2_pairs<false>, std::make_tuple(it, itNext), data,
+                                            std::ref(_energies), std::ref(_virials),
+                                            std::cref(ctx.potentials().tableOrder2())
+                                    ));
+                                }
+                                it = itNext;
+                            }
                         } else {
-                            tasks.push_back(pool.pack(
-                                    calculate_order2<false>, std::make_tuple(it, nCells), data, std::cref(*neighborList),
-                                    std::ref(promises.back()), std::ref(virialPromises.back()),
-                                    ctx.potentials().potentialsOrder2(), ctx.shortestDifferenceFun()
-                            ));
+                            auto it = blocks.data();
+                            const auto end = blocks.data() + blocks.size();
+                            for (auto i = 0_z; i < nTasksColor; ++i) {
+                                auto itNext = i == nTasksColor - 1 ? end : it + grainSize;
+                                if (ctx.recordVirial()) {
+                                    tasks.push_back(pool.pack(
+                                            calculate_order2<true>, std::make_tuple(it, itNext), data,
+                                            std::cref(*neighborList), std::ref(_energies), std::ref(_virials),
+                                            std::cref(ctx.potentials().tableOrder2()),
+                                            std::cref(ctx)
+                                    ));
+                                } else {
+                                    tasks.push_back(pool.pack(
+                                            calculate_order2<false>, std::make_tuple(it, itNext), data,
+                                            std::cref(*neighborList), std::ref(_energies), std::ref(_virials),
+                                            std::cref(ctx.potentials().tableOrder2()),
+                                            std::cref(ctx)
+                                    ));
+                                }
+                                it = itNext;
+                            }
+                        }
+                        {
+                            auto tPush = nTasks.subnode("execute order 2 tasks and wait").timeit();
+                            auto futures = pool.pushAll(std::move(tasks));
+                            std::vector<util::thread::joining_future<void>> joiningFutures;
+                            std::transform(futures.begin(), futures.end(), std::back_inserter(joiningFutures),
+                                           [](auto &&future) {
+                                               return util::thread::joining_future<void>{std::move(future)};
+                                           });
                         }
-                    }
-                    {
-                        auto tPush = nTasks.subnode("execute order 2 tasks and wait").timeit();
-                        auto futures = pool.pushAll(std::move(tasks));
-                        std::vector<util::thread::joining_future<void>> joiningFutures;
-                        std::transform(futures.begin(), futures.end(), std::back_inserter(joiningFutures),
-                                       [](auto &&future) {
-                                           return util::thread::joining_future<void>{std::move(future)};
-                                       });
                     }
                 }
             }
 
             {
-                auto tFutures = node.subnode("get energy futures").timeit();
-                for (auto &f : promises) {
-                    stateModel.energy() += f.get_future().get();
-                }
-            }
-            {
-                auto tVirialFutures = node.subnode("get virial futures").timeit();
-                for (auto &f : virialPromises) {
-                    stateModel.virial() += f.get_future().get();
+                auto tReduce = node.subnode("reduce energy and virial").timeit();
+                stateModel.energy() = static_cast<scalar>(_energies.reduce());
+                if (ctx.recordVirial()) {
+                    const auto &virial = _virials.reduce().data();
+                    std::transform(virial.begin(), virial.end(), stateModel.virial().data().begin(),
+                                   [](accumulator_type v) { return static_cast<scalar>(v); });
                 }
             }
         }
@@ -215,116 +234,200 @@ void CPUCalculateForces::perform(const util::PerformanceNode &node) {
 }
 
 template<bool COMPUTE_VIRIAL>
-void CPUCalculateForces::calculate_order2(std::size_t, nl_bounds nlBounds,
+void CPUCalculateForces::calculate_order2(std::size_t tid, nl_bounds nlBounds,
                                           CPUStateModel::data_type *data, const CPUStateModel::neighbor_list &nl,
-                                          std::promise<scalar> &energyPromise, std::promise<Matrix33> &virialPromise,
-                                          model::potentials::PotentialRegistry::potential_o2_registry pot2,
-                                          model::Context::shortest_dist_fun d) {
-    scalar energyUpdate = 0.0;
-    Matrix33 virialUpdate{{{0, 0, 0, 0, 0, 0, 0, 0, 0}}};
+                                          Reduction<accumulator_type> &energy, Reduction<virial_type> &virial,
+                                          const model::potentials::PairPotentialTable &pot2,
+                                          const model::Context &context) {
+    accumulator_type energyUpdate = 0;
+    virial_type virialUpdate;
+    auto &virialData = virialUpdate.data();
+
+    NeighborLanes lanes(context.boxSize(), context.periodicBoundaryConditions());
+    const auto shifted = nl.imageShiftsAvailable();
+    const Vec3 noShift{0, 0, 0};
+
+    const auto &positions = data->positions();
+    auto &forces = data->forces();
+    const auto &types = data->types();
+    const auto &deactivated = data->deactivated();
 
     //
     // 2nd order potentials
     //
-    for (auto cell = std::get<0>(nlBounds); cell < std::get<1>(nlBounds); ++cell) {
-        for (auto particleIt = nl.particlesBegin(cell); particleIt != nl.particlesEnd(cell); ++particleIt) {
-            auto &entry = data->entry_at(*particleIt);
-            if (entry.deactivated) {
-                log::critical("deactivated particle in neighbor list!");
-                continue;
-            }
+    for (auto block = std::get<0>(nlBounds); block != std::get<1>(nlBounds); ++block) {
+        nl.forEachCellInBlock(*block, [&](std::size_t cell) {
+            for (auto particleIt = nl.particlesBegin(cell); particleIt != nl.particlesEnd(cell); ++particleIt) {
+                const auto particle = *particleIt;
+                if (deactivated[particle]) {
+                    log::critical("deactivated particle in neighbor list!");
+                    continue;
+                }
+                const auto type = types[particle];
+                // a pair only interacts if both of its types have second order potentials
+                if (!pot2.interacts(type)) continue;
 
-            nl.forEachNeighbor(*particleIt, cell, [&](auto neighborIndex) {
-                auto &neighbor = data->entry_at(neighborIndex);
-                if (!neighbor.deactivated) {
-                    auto &force = entry.force;
-                    const auto &myPos = entry.pos;
+                // gather the interacting neighbor candidates and compute their distances in one pass
+                lanes.clear();
+                auto gather = [&](std::size_t neighborIndex, const Vec3 &shift) {
+                    if (!deactivated[neighborIndex]) {
+                        const auto neighborType = types[neighborIndex];
+                        if (pot2.begin(type, neighborType) != pot2.end(type, neighborType)) {
+                            lanes.push_back(neighborIndex, positions[neighborIndex] + shift);
+                        }
+                    } else {
+                        log::critical("disabled neighbour");
+                    }
+                };
+                if (shifted) {
+                    // neighbors are moved to their image next to the cell, no minimum image convention needed
+                    nl.forEachHalfNeighborShifted(particleIt, cell, gather);
+                    if (lanes.empty()) continue;
+                    lanes.computePlainDifferences(positions[particle]);
+                } else {
+                    nl.forEachHalfNeighbor(particleIt, cell, [&](auto neighborIndex) {
+                        gather(neighborIndex, noShift);
+                    });
+                    if (lanes.empty()) continue;
+                    lanes.computeDifferences(positions[particle]);
+                }
 
-                    //
-                    // 2nd order potentials
-                    //
-                    scalar mySecondOrderEnergy = 0.;
-                    auto potit = pot2.find(std::tie(entry.type, neighbor.type));
-                    if (potit != pot2.end()) {
-                        auto x_ij = d(myPos, neighbor.pos);
-                        auto distSquared = x_ij * x_ij;
-                        for (const auto &potential : potit->second) {
-                            if (distSquared < potential->getCutoffRadiusSquared()) {
-                                Vec3 forceUpdate{0, 0, 0};
-                                potential->calculateForceAndEnergy(forceUpdate, mySecondOrderEnergy, x_ij);
-                                force += forceUpdate;
-                                if(COMPUTE_VIRIAL && *particleIt < neighborIndex) {
-                                    virialUpdate += math::outerProduct(-1.*x_ij, force);
+                for (auto lane = 0_z; lane < lanes.size(); ++lane) {
+                    const auto neighbor = lanes.index(lane);
+                    const auto neighborType = types[neighbor];
+                    const auto distSquared = lanes.distSquared(lane);
+                    const auto potBegin = pot2.begin(type, neighborType);
+                    const auto potEnd = pot2.end(type, neighborType);
+                    for (auto potential = potBegin; potential != potEnd; ++potential) {
+                        if (distSquared < potential->cutoffSquared) {
+                            const auto x_ij = lanes.difference(lane);
+                            Vec3 forceUpdate{0, 0, 0};
+                            scalar energyPair{0};
+                            model::potentials::calculateForceAndEnergy(*potential, forceUpdate, energyPair,
+                                                                       x_ij, distSquared);
+                            energyUpdate += energyPair;
+                            forces[particle] += forceUpdate;
+                            forces[neighbor] -= forceUpdate;
+                            if (COMPUTE_VIRIAL) {
+                                // same layout as math::outerProduct(-x_ij, forceUpdate)
+                                for (std::size_t j = 0; j < 3; ++j) {
+                                    for (std::size_t i = 0; i < 3; ++i) {
+                                        virialData[3 * j + i] -= x_ij[j] * forceUpdate[i];
+                                    }
                                 }
                             }
                         }
                     }
-
-                    // The contribution of second order potentials must be halved since we parallelize over particles.
-                    // Thus every particle pair potential is seen twice
-                    energyUpdate += 0.5 * mySecondOrderEnergy;
-                } else {
-                    log::critical("disabled neighbour");
                 }
-            });
-        }
+            }
+        });
+    }
 
+    energy.local(tid) += energyUpdate;
+    if (COMPUTE_VIRIAL) {
+        virial.local(tid) += virialUpdate;
     }
 
-    energyPromise.set_value(energyUpdate);
-    virialPromise.set_value(virialUpdate);
+}
+
+template<bool COMPUTE_VIRIAL>
+void CPUCalculateForces::calculate_order2_pairs(std::size_t tid, pair_bounds pairBounds,
+                                                CPUStateModel::data_type *data, Reduction<accumulator_type> &energy,
+                                                Reduction<virial_type> &virial,
+                                                const model::potentials::PairPotentialTable &pot2) {
+    accumulator_type energyUpdate = 0;
+    virial_type virialUpdate;
+    auto &virialData = virialUpdate.data();
+
+    auto &forces = data->forces();
+    const auto &types = data->types();
+    for (auto block = std::get<0>(pairBounds); block != std::get<1>(pairBounds); ++block) {
+        for (const auto &pair : *block) {
+            const auto potEnd = pot2.end(types[pair.i], types[pair.j]);
+            for (auto potential = pot2.begin(types[pair.i], types[pair.j]); potential != potEnd; ++potential) {
+                if (pair.distSquared < potential->cutoffSquared) {
+                    Vec3 forceUpdate{0, 0, 0};
+                    scalar energyPair{0};
+                    model::potentials::calculateForceAndEnergy(*potential, forceUpdate, energyPair, pair.x_ij,
+                                                               pair.distSquared);
+                    energyUpdate += energyPair;
+                    forces[pair.i] += forceUpdate;
+                    forces[pair.j] -= forceUpdate;
+                    if (COMPUTE_VIRIAL) {
+                        // same layout as math::outerProduct(-x_ij, forceUpdate)
+                        for (std::size_t j = 0; j < 3; ++j) {
+                            for (std::size_t i = 0; i < 3; ++i) {
+                                virialData[3 * j + i] -= pair.x_ij[j] * forceUpdate[i];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
 
+    energy.local(tid) += energyUpdate;
+    if (COMPUTE_VIRIAL) {
+        virial.local(tid) += virialUpdate;
+    }
 }
 
-void CPUCalculateForces::calculate_topologies(std::size_t, top_bounds topBounds,
+void CPUCalculateForces::calculate_topologies(std::size_t tid, top_bounds topBounds,
                                               model::top::TopologyActionFactory *taf,
-                                              std::promise<scalar> &energyPromise) {
-    scalar energyUpdate = 0.0;
+                                              Reduction<accumulator_type> &energy) {
+    accumulator_type energyUpdate = 0;
     for (auto it = std::get<0>(topBounds); it != std::get<1>(topBounds); ++it) {
         const auto &top = *it;
         if (!top->isDeactivated()) {
             for (const auto &bondedPot : top->getBondedPotentials()) {
-                auto energy = bondedPot->createForceAndEnergyAction(taf)->perform(top.get());
-                energyUpdate += energy;
+                energyUpdate += bondedPot->createForceAndEnergyAction(taf)->perform(top.get());
             }
             for (const auto &anglePot : top->getAnglePotentials()) {
-                auto energy = anglePot->createForceAndEnergyAction(taf)->perform(top.get());
-                energyUpdate += energy;
+                energyUpdate += anglePot->createForceAndEnergyAction(taf)->perform(top.get());
             }
             for (const auto &torsionPot : top->getTorsionPotentials()) {
-                auto energy = torsionPot->createForceAndEnergyAction(taf)->perform(top.get());
-                energyUpdate += energy;
+                energyUpdate += torsionPot->createForceAndEnergyAction(taf)->perform(top.get());
             }
         }
     }
 
-    energyPromise.set_value(energyUpdate);
+    energy.local(tid) += energyUpdate;
 }
 
-void CPUCalculateForces::calculate_order1(std::size_t, data_bounds dataBounds,
-                                          std::promise<scalar> &energyPromise, CPUStateModel::data_type *data,
-                                          model::potentials::PotentialRegistry::potential_o1_registry pot1,
-                                          model::Context::shortest_dist_fun d) {
-    scalar energyUpdate = 0.0;
+void CPUCalculateForces::calculate_order1(std::size_t tid, index_bounds indexBounds,
+                                          Reduction<accumulator_type> &energy, CPUStateModel::data_type *data,
+                                          const model::potentials::ExternalPotentialTable &pot1,
+                                          std::vector<std::vector<ExternalLanes>> &buckets) {
+    accumulator_type energyUpdate = 0;
 
     //
     // 1st order potentials
     //
-    for (auto it = std::get<0>(dataBounds); it != std::get<1>(dataBounds); ++it) {
-        auto &entry = *it;
-        if (!entry.deactivated) {
-            auto &force = entry.force;
-            force = {c_::zero, c_::zero, c_::zero};
-            const auto &myPos = entry.pos;
-            auto find_it = pot1.find(entry.type);
-            if (find_it != pot1.end()) {
-                for (const auto &potential : find_it->second) {
-                    potential->calculateForceAndEnergy(force, energyUpdate, myPos);
-                }
-            }
+    // bucket the particles by type, so that each potential is applied to all particles of its type in one pass
+    auto &lanesOfType = buckets[tid];
+    for (auto &lanes : lanesOfType) {
+        lanes.clear();
+    }
+    const auto &positions = data->positions();
+    auto &forces = data->forces();
+    const auto &types = data->types();
+    for (auto it = std::get<0>(indexBounds); it != std::get<1>(indexBounds); ++it) {
+        const auto type = types[*it];
+        if (pot1.begin(type) != pot1.end(type)) {
+            lanesOfType[type].push_back(*it, positions[*it]);
+        }
+    }
+    for (std::size_t type = 0; type < lanesOfType.size(); ++type) {
+        auto &lanes = lanesOfType[type];
+        if (lanes.empty()) continue;
+        lanes.evaluate(pot1.begin(static_cast<particle_type_type>(type)),
+                       pot1.end(static_cast<particle_type_type>(type)));
+        for (auto lane = 0_z; lane < lanes.size(); ++lane) {
+            forces[lanes.index(lane)] += lanes.force(lane);
+            energyUpdate += lanes.energy(lane);
         }
     }
-    energyPromise.set_value(energyUpdate);
+    energy.local(tid) += energyUpdate;
 }
 }
 }
@@ -29,6 +29,7 @@
  * @date 07.07.16
  */
 
+#include <readdy/common/boundary_condition_operations.h>
 #include <readdy/kernel/cpu/actions/CPUEulerBDIntegrator.h>
 
 namespace readdy {
@@ -42,51 +43,64 @@ void CPUEulerBDIntegrator::perform(const readdy::util::PerformanceNode &node) {
     auto t = node.timeit();
     auto data = kernel->getCPUKernelStateModel().getParticleData();
     const auto size = data->size();
+    // all particles move, the neighbor list cannot be updated incrementally
+    data->invalidateEdits();
 
     const auto &context = kernel->context();
-    using iter_t = data::EntryDataContainer::iterator;
 
     const auto dt = timeStep;
+    // the integrator only streams through the positions, forces, types, and flags of the particles
+    auto &positions = data->positions();
+    const auto &forces = data->forces();
+    const auto &types = data->types();
+    const auto &deactivated = data->deactivated();
 
-    auto worker = [&context, data, dt](std::size_t, std::size_t beginIdx, iter_t entry_begin, iter_t entry_end)  {
-        const auto &fixPos = context.fixPositionFun();
-        const auto kbt = context.kBT();
-        std::size_t idx = beginIdx;
-        for (auto it = entry_begin; it != entry_end; ++it, ++idx) {
-            if(!it->deactivated) {
-                const scalar D = context.particle_types().diffusionConstantOf(it->type);
-                const auto randomDisplacement = std::sqrt(2. * D * dt) * rnd::normal3<readdy::scalar>(0, 1);
-                const auto deterministicDisplacement = it->force * dt * D / kbt;
-                data->displace(idx, randomDisplacement + deterministicDisplacement);
+    // the boundary conditions are resolved once, the worker is instantiated for each combination of periodic axes
+    bcs::dispatchPeriodicBoundaries(context.periodicBoundaryConditions(), [&](auto boundaries) {
+        using boundaries_t = decltype(boundaries);
+        const auto &box = context.boxSize();
+        auto worker = [&](std::size_t, std::size_t begin, std::size_t end) {
+            const auto kbt = context.kBT();
+            const auto &potentials = context.potentials();
+            for (auto index = begin; index != end; ++index) {
+                if (!deactivated[index]) {
+                    const auto type = types[index];
+                    auto &pos = positions[index];
+                    const scalar D = context.particle_types().diffusionConstantOf(type);
+                    const auto randomDisplacement = std::sqrt(2. * D * dt) * rnd::normal3<readdy::scalar>(0, 1);
+                    if (potentials.interacting(type)) {
+                        const auto deterministicDisplacement = forces[index] * dt * D / kbt;
+                        pos += randomDisplacement + deterministicDisplacement;
+                    } else {
+                        // pure diffusion, the particle cannot feel a force
+                        pos += randomDisplacement;
+                    }
+                    boundaries_t::fixPosition(pos, box);
+                }
             }
-        }
-    };
+        };
 
-    std::vector<util::thread::joining_future<void>> waitingFutures;
-    waitingFutures.reserve(kernel->getNThreads());
-    auto &pool  = kernel->pool();
-    {
-        auto it = data->begin();
-        std::vector<std::function<void(std::size_t)>> executables;
-        executables.reserve(kernel->getNThreads());
+        std::vector<util::thread::joining_future<void>> waitingFutures;
+        waitingFutures.reserve(kernel->getNThreads());
+        auto &pool = kernel->pool();
+        {
+            auto it = 0_z;
 
-        auto granularity = kernel->getNThreads();
-        const std::size_t grainSize = size / granularity;
+            auto granularity = kernel->getNThreads();
+            const std::size_t grainSize = size / granularity;
 
-        std::size_t idx = 0;
-        for (auto i = 0_z; i < granularity-1; ++i) {
-            auto itNext = it + grainSize;
-            if(it != itNext) {
-                waitingFutures.emplace_back(pool.push(worker, idx, it, itNext));
+            for (auto i = 0_z; i < granularity - 1; ++i) {
+                auto itNext = it + grainSize;
+                if (it != itNext) {
+                    waitingFutures.emplace_back(pool.push(worker, it, itNext));
+                }
+                it = itNext;
+            }
+            if (it != size) {
+                waitingFutures.emplace_back(pool.push(worker, it, size));
             }
-            it = itNext;
-            idx += grainSize;
-        }
-        if(it != data->end()) {
-            waitingFutures.emplace_back(pool.push(worker, idx, it, data->end()));
         }
-    }
-
+    });
 }
 
 CPUEulerBDIntegrator::CPUEulerBDIntegrator(CPUKernel *kernel, scalar timeStep)
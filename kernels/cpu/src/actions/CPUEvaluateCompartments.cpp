@@ -40,14 +40,16 @@ void CPUEvaluateCompartments::perform(const util::PerformanceNode &node) {
     auto t = node.timeit();
     const auto &ctx = kernel->context();
     const auto &compartments = ctx.compartments().get();
-    for(auto& e : *kernel->getCPUKernelStateModel().getParticleData()) {
+    auto &data = *kernel->getCPUKernelStateModel().getParticleData();
+    for(std::size_t index = 0; index < data.size(); ++index) {
+        const auto &e = data.entry_at(index);
         if(!e.deactivated) {
             for (const auto &compartment : compartments) {
                 if (compartment->isContained(e.pos)) {
                     const auto &conversions = compartment->getConversions();
                     const auto convIt = conversions.find(e.type);
                     if (convIt != conversions.end()) {
-                        e.type = (*convIt).second;
+                        data.setType(index, (*convIt).second);
                     }
                 }
             }
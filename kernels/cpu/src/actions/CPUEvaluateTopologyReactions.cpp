@@ -346,8 +346,8 @@ void CPUEvaluateTopologyReactions::handleTopologyParticleReaction(CPUStateModel:
     auto& model = kernel->getCPUKernelStateModel();
     auto& data = *model.getParticleData();
 
-    auto& entry1 = data.entry_at(event.idx1);
-    auto& entry2 = data.entry_at(event.idx2);
+    auto entry1 = data.entry_at(event.idx1);
+    auto entry2 = data.entry_at(event.idx2);
     auto& entry1Type = entry1.type;
     auto& entry2Type = entry2.type;
     if(entry1Type == reaction.type1()) {
@@ -389,8 +389,8 @@ void CPUEvaluateTopologyReactions::handleTopologyTopologyReaction(CPUStateModel:
     auto& model = kernel->getCPUKernelStateModel();
     auto& data = *model.getParticleData();
 
-    auto& entry1 = data.entry_at(event.idx1);
-    auto& entry2 = data.entry_at(event.idx2);
+    auto entry1 = data.entry_at(event.idx1);
+    auto entry2 = data.entry_at(event.idx2);
     auto& entry1Type = entry1.type;
     auto& entry2Type = entry2.type;
     auto top_type_to1 = reaction.top_type_to1();
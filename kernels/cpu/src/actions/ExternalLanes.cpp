@@ -0,0 +1,65 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * This file is part of ReaDDy.                                     *
+ *                                                                  *
+ * ReaDDy is free software: you can redistribute it and/or modify   *
+ * it under the terms of the GNU Lesser General Public License as   *
+ * published by the Free Software Foundation, either version 3 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU Lesser General Public License for more details.              *
+ *                                                                  *
+ * You should have received a copy of the GNU Lesser General        *
+ * Public License along with this program. If not, see              *
+ * <http://www.gnu.org/licenses/>.                                  *
+ ********************************************************************/
+
+
+/**
+ * @file ExternalLanes.cpp
+ * @author clonker
+ * @date 08.02.18
+ */
+
+#include <readdy/common/macros.h>
+#include <readdy/kernel/cpu/actions/ExternalLanes.h>
+
+namespace readdy {
+namespace kernel {
+namespace cpu {
+namespace actions {
+
+namespace {
+
+READDY_TARGET_CLONES
+void forcesAndEnergies(model::potentials::ExternalPotentialTable::const_iterator begin,
+                       model::potentials::ExternalPotentialTable::const_iterator end, std::size_t n,
+                       const scalar *x, const scalar *y, const scalar *z,
+                       scalar *fx, scalar *fy, scalar *fz, scalar *energy) {
+    for (auto potential = begin; potential != end; ++potential) {
+        model::potentials::calculateForcesAndEnergies(*potential, n, x, y, z, fx, fy, fz, energy);
+    }
+}
+
+}
+
+void ExternalLanes::evaluate(model::potentials::ExternalPotentialTable::const_iterator begin,
+                             model::potentials::ExternalPotentialTable::const_iterator end) {
+    const auto n = size();
+    _fx.assign(n, c_::zero);
+    _fy.assign(n, c_::zero);
+    _fz.assign(n, c_::zero);
+    _energy.assign(n, c_::zero);
+    forcesAndEnergies(begin, end, n, _x.data(), _y.data(), _z.data(), _fx.data(), _fy.data(), _fz.data(),
+                      _energy.data());
+}
+
+}
+}
+}
+}
@@ -0,0 +1,117 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * This file is part of ReaDDy.                                     *
+ *                                                                  *
+ * ReaDDy is free software: you can redistribute it and/or modify   *
+ * it under the terms of the GNU Lesser General Public License as   *
+ * published by the Free Software Foundation, either version 3 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU Lesser General Public License for more details.              *
+ *                                                                  *
+ * You should have received a copy of the GNU Lesser General        *
+ * Public License along with this program. If not, see              *
+ * <http://www.gnu.org/licenses/>.                                  *
+ ********************************************************************/
+
+
+/**
+ * << detailed description >>
+ *
+ * @file NeighborLanes.cpp
+ * @brief << brief description >>
+ * @author clonker
+ * @date 06.02.18
+ */
+
+#include <limits>
+#include <readdy/common/macros.h>
+#include <readdy/kernel/cpu/actions/NeighborLanes.h>
+
+namespace readdy {
+namespace kernel {
+namespace cpu {
+namespace actions {
+
+NeighborLanes::NeighborLanes(const std::array<scalar, 3> &boxSize, const std::array<bool, 3> &periodic) {
+    for (int d = 0; d < 3; ++d) {
+        _period[d] = periodic[d] ? boxSize[d] : c_::zero;
+        _halfPeriod[d] = periodic[d] ? c_::half * boxSize[d] : std::numeric_limits<scalar>::infinity();
+    }
+    grow();
+}
+
+void NeighborLanes::grow() {
+    const auto capacity = std::max(static_cast<std::size_t>(64), 2 * _indices.size());
+    _indices.resize(capacity);
+    _x.resize(capacity);
+    _y.resize(capacity);
+    _z.resize(capacity);
+    _dx.resize(capacity);
+    _dy.resize(capacity);
+    _dz.resize(capacity);
+    _d2.resize(capacity);
+}
+
+namespace {
+
+READDY_TARGET_CLONES
+void minimumImageDifferences(std::size_t n, const scalar *__restrict x, const scalar *__restrict y,
+                             const scalar *__restrict z, scalar *__restrict dx, scalar *__restrict dy,
+                             scalar *__restrict dz, scalar *__restrict d2, const Vec3 &pos,
+                             const std::array<scalar, 3> &period, const std::array<scalar, 3> &halfPeriod) {
+    const scalar px = pos.x, py = pos.y, pz = pos.z;
+    const scalar lx = period[0], ly = period[1], lz = period[2];
+    const scalar hx = halfPeriod[0], hy = halfPeriod[1], hz = halfPeriod[2];
+    // branch-free version of bcs::shortestDifference, yields the same results
+    for (std::size_t i = 0; i < n; ++i) {
+        auto vx = x[i] - px;
+        auto vy = y[i] - py;
+        auto vz = z[i] - pz;
+        vx += (vx <= -hx ? lx : c_::zero) - (vx > hx ? lx : c_::zero);
+        vy += (vy <= -hy ? ly : c_::zero) - (vy > hy ? ly : c_::zero);
+        vz += (vz <= -hz ? lz : c_::zero) - (vz > hz ? lz : c_::zero);
+        dx[i] = vx;
+        dy[i] = vy;
+        dz[i] = vz;
+        d2[i] = vx * vx + vy * vy + vz * vz;
+    }
+}
+
+
+READDY_TARGET_CLONES
+void plainDifferences(std::size_t n, const scalar *__restrict x, const scalar *__restrict y,
+                      const scalar *__restrict z, scalar *__restrict dx, scalar *__restrict dy,
+                      scalar *__restrict dz, scalar *__restrict d2, const Vec3 &pos) {
+    const scalar px = pos.x, py = pos.y, pz = pos.z;
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto vx = x[i] - px;
+        const auto vy = y[i] - py;
+        const auto vz = z[i] - pz;
+        dx[i] = vx;
+        dy[i] = vy;
+        dz[i] = vz;
+        d2[i] = vx * vx + vy * vy + vz * vz;
+    }
+}
+
+}
+
+void NeighborLanes::computeDifferences(const Vec3 &pos) {
+    minimumImageDifferences(_size, _x.data(), _y.data(), _z.data(), _dx.data(), _dy.data(), _dz.data(), _d2.data(),
+                            pos, _period, _halfPeriod);
+}
+
+void NeighborLanes::computePlainDifferences(const Vec3 &pos) {
+    plainDifferences(_size, _x.data(), _y.data(), _z.data(), _dx.data(), _dy.data(), _dz.data(), _d2.data(), pos);
+}
+
+}
+}
+}
+}
@@ -28,6 +28,7 @@
  * @author clonker
  * @date 20.10.16
  */
+#include <readdy/common/boundary_condition_operations.h>
 #include <readdy/kernel/cpu/actions/reactions/CPUGillespie.h>
 
 
@@ -47,17 +48,24 @@ void CPUGillespie::perform(const util::PerformanceNode &node) {
     }
     auto &stateModel = kernel->getCPUKernelStateModel();
     auto data = stateModel.getParticleData();
-    const auto &dist = ctx.distSquaredFun();
-    const auto &fixPos = ctx.fixPositionFun();
     const auto nl = stateModel.getNeighborList();
 
     if(ctx.recordReactionCounts()) {
         stateModel.resetReactionCounts();
     }
 
+    stateModel.updatePairList(node.subnode("update pair list"));
+
     scalar alpha = 0.0;
     std::vector<event_t> events;
-    gatherEvents(kernel, readdy::util::range<event_t::index_type>(0, data->size()), nl, data, alpha, events, dist);
+    bcs::dispatchPeriodicBoundaries(ctx.periodicBoundaryConditions(), [&](auto boundaries) {
+        using boundaries_t = decltype(boundaries);
+        const auto &box = ctx.boxSize();
+        gatherEvents(kernel, readdy::util::range<event_t::index_type>(0, data->size()), nl, data, alpha, events,
+                     [&box](const Vec3 &lhs, const Vec3 &rhs) {
+                         return boundaries_t::distSquared(lhs, rhs, box);
+                     });
+    });
     if(ctx.recordReactionsWithPositions()) {
         stateModel.reactionRecords().clear();
         if(ctx.recordReactionCounts()) {
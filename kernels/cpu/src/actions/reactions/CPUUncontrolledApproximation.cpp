@@ -32,6 +32,7 @@
 #include <future>
 #include <random>
 
+#include <readdy/common/boundary_condition_operations.h>
 #include <readdy/kernel/cpu/actions/reactions/CPUUncontrolledApproximation.h>
 #include <readdy/kernel/cpu/actions/reactions/Event.h>
 #include <readdy/kernel/cpu/actions/reactions/ReactionUtils.h>
@@ -48,22 +49,23 @@ using event_t = Event;
 using data_iter_t = data_t::const_iterator;
 using neighbor_list = CPUStateModel::neighbor_list;
 using nl_bounds = std::tuple<std::size_t, std::size_t>;
+using pair_bounds = std::tuple<const nl::PairList::pairs *, const nl::PairList::pairs *>;
 using entry_type = data_t::Entries::value_type;
 
-using event_future_t = std::future<std::vector<event_t>>;
-using event_promise_t = std::promise<std::vector<event_t>>;
+using events_reduction_t = Reduction<std::vector<event_t>>;
 
 CPUUncontrolledApproximation::CPUUncontrolledApproximation(CPUKernel *const kernel, scalar timeStep)
         : super(timeStep), kernel(kernel) {
 
 }
 
-void findEvents(std::size_t /*tid*/, data_iter_t begin, data_iter_t end, nl_bounds nlBounds,
+template<typename Boundaries>
+void findEvents(std::size_t tid, data_iter_t begin, data_iter_t end, nl_bounds nlBounds, pair_bounds pairBounds,
                 const CPUKernel *const kernel, scalar dt, bool approximateRate, const neighbor_list &nl,
-                event_promise_t &events, std::promise<std::size_t> &n_events) {
-    std::vector<event_t> eventsUpdate;
+                events_reduction_t &events) {
+    auto &eventsUpdate = events.local(tid);
     const auto &data = *kernel->getCPUKernelStateModel().getParticleData();
-    const auto &d2 = kernel->context().distSquaredFun();
+    const auto &box = kernel->context().boxSize();
     auto index = static_cast<std::size_t>(std::distance(data.begin(), begin));
     for (auto it = begin; it != end; ++it, ++index) {
         const auto &entry = *it;
@@ -97,7 +99,7 @@ void findEvents(std::size_t /*tid*/, data_iter_t begin, data_iter_t end, nl_boun
                 if(!neighbor.deactivated) {
                     const auto &reactions = kernel->context().reactions().order2ByType(entry.type, neighbor.type);
                     if (!reactions.empty()) {
-                        const auto distSquared = d2(neighbor.pos, entry.pos);
+                        const auto distSquared = Boundaries::distSquared(neighbor.pos, entry.pos, box);
                         for (auto it_reactions = reactions.begin(); it_reactions < reactions.end(); ++it_reactions) {
                             const auto &react = *it_reactions;
                             const auto rate = react->rate();
@@ -114,9 +116,29 @@ void findEvents(std::size_t /*tid*/, data_iter_t begin, data_iter_t end, nl_boun
             });
         }
     }
-
-    n_events.set_value(eventsUpdate.size());
-    events.set_value(std::move(eventsUpdate));
+    // each pair of the pair list is visited once, so both particles take the role of the first educt
+    const auto findPairEvents = [&](std::size_t idx1, std::size_t idx2, scalar distSquared) {
+        const auto &entry = data.entry_at(idx1);
+        const auto &neighbor = data.entry_at(idx2);
+        const auto &reactions = kernel->context().reactions().order2ByType(entry.type, neighbor.type);
+        for (auto it_reactions = reactions.begin(); it_reactions < reactions.end(); ++it_reactions) {
+            const auto &react = *it_reactions;
+            const auto rate = react->rate();
+            if (rate > 0 && distSquared < react->eductDistanceSquared()
+                && shouldPerformEvent(rate, dt, approximateRate)) {
+                const auto reaction_index = static_cast<event_t::reaction_index_type>(it_reactions -
+                                                                                      reactions.begin());
+                eventsUpdate.emplace_back(2, react->nProducts(), idx1, idx2, rate, 0, reaction_index, entry.type,
+                                          neighbor.type);
+            }
+        }
+    };
+    for (auto block = std::get<0>(pairBounds); block != std::get<1>(pairBounds); ++block) {
+        for (const auto &pair : *block) {
+            findPairEvents(pair.i, pair.j, pair.distSquared);
+            findPairEvents(pair.j, pair.i, pair.distSquared);
+        }
+    }
 }
 
 void CPUUncontrolledApproximation::perform(const util::PerformanceNode &node) {
@@ -135,46 +157,62 @@ void CPUUncontrolledApproximation::perform(const util::PerformanceNode &node) {
     }
 
     // gather events
-    std::vector<std::promise<std::size_t>> n_events_promises(kernel->getNThreads());
-    std::vector<event_promise_t> promises(kernel->getNThreads());
     {
-
         auto &pool = kernel->pool();
+        this->events.reset(pool.size(), {});
+        std::vector<util::thread::joining_future<void>> futures;
+        futures.reserve(kernel->getNThreads());
 
-        std::vector<std::function<void(std::size_t)>> executables;
-        executables.reserve(kernel->getNThreads());
+        // instantiation of findEvents for the current boundary conditions
+        const auto find = bcs::dispatchPeriodicBoundaries(ctx.periodicBoundaryConditions(), [](auto boundaries) {
+            return &findEvents<decltype(boundaries)>;
+        });
+
+        // with the pair list, the pairs are distributed over the threads instead of the cells
+        const auto &pairList = stateModel.pairList();
+        stateModel.updatePairList(node.subnode("update pair list"));
+        const auto nCells = pairList.enabled() ? 0_z : nl->nCells();
+        const auto pairsBegin = pairList.blockPairs().data();
+        const auto pairsEnd = pairsBegin + (pairList.enabled() ? pairList.blockPairs().size() : 0_z);
 
         std::size_t grainSize = data.size() / kernel->getNThreads();
-        std::size_t nlGrainSize = nl->nCells() / kernel->getNThreads();
+        std::size_t nlGrainSize = nCells / kernel->getNThreads();
+        std::size_t pairsGrainSize = static_cast<std::size_t>(pairsEnd - pairsBegin) / kernel->getNThreads();
 
         auto it = data.cbegin();
         std::size_t it_nl = 0;
+        auto it_pairs = pairsBegin;
         for (auto i = 0U; i < kernel->getNThreads()-1 ; ++i) {
             auto itNext = std::min(it+grainSize, data.cend());
 
-            auto nlNext = std::min(it_nl + nlGrainSize, nl->nCells());
+            auto nlNext = std::min(it_nl + nlGrainSize, nCells);
             auto bounds_nl = std::make_tuple(it_nl, nlNext);
 
-            pool.push(findEvents, it, itNext, bounds_nl, kernel, timeStep, false, std::cref(*nl),
-                      std::ref(promises.at(i)), std::ref(n_events_promises.at(i)));
+            auto pairsNext = it_pairs + pairsGrainSize;
+            auto bounds_pairs = std::make_tuple(it_pairs, pairsNext);
+
+            futures.emplace_back(pool.push(find, it, itNext, bounds_nl, bounds_pairs, kernel, timeStep, false,
+                                           std::cref(*nl), std::ref(this->events)));
 
             it = itNext;
             it_nl = nlNext;
+            it_pairs = pairsNext;
         }
-        pool.push(findEvents, it, data.cend(), std::make_tuple(it_nl, nl->nCells()), kernel, timeStep, false,
-                  std::cref(*nl), std::ref(promises.back()), std::ref(n_events_promises.back()));
+        futures.emplace_back(pool.push(find, it, data.cend(), std::make_tuple(it_nl, nCells),
+                                       std::make_tuple(it_pairs, pairsEnd), kernel, timeStep, false,
+                                       std::cref(*nl), std::ref(this->events)));
     }
 
     // collect events
     std::vector<event_t> events;
     {
         std::size_t n_events = 0;
-        for (auto &&f : n_events_promises) {
-            n_events += f.get_future().get();
+        for (auto tid = 0_z; tid < this->events.size(); ++tid) {
+            n_events += this->events.local(tid).size();
         }
         events.reserve(n_events);
-        for (auto &&f : promises) {
-            auto eventUpdate = std::move(f.get_future().get());
+        for (auto tid = 0_z; tid < this->events.size(); ++tid) {
+            auto &eventUpdate = this->events.local(tid);
             auto mBegin = std::make_move_iterator(eventUpdate.begin());
             auto mEnd = std::make_move_iterator(eventUpdate.end());
             events.insert(events.end(), mBegin, mEnd);
@@ -49,8 +49,8 @@ readdy::scalar CPUCalculateHarmonicBondPotential::perform(const readdy::model::t
     const auto &d = context->shortestDifferenceFun();
     for (const auto &bond : potential->getBonds()) {
         Vec3 forceUpdate{0, 0, 0};
-        auto &e1 = data->entry_at(particleIndices.at(bond.idx1));
-        auto &e2 = data->entry_at(particleIndices.at(bond.idx2));
+        auto e1 = data->entry_at(particleIndices.at(bond.idx1));
+        auto e2 = data->entry_at(particleIndices.at(bond.idx2));
         const auto x_ij = d(e1.pos, e2.pos);
         potential->calculateForce(forceUpdate, x_ij, bond);
         e1.force += forceUpdate;
@@ -73,9 +73,9 @@ readdy::scalar CPUCalculateHarmonicAnglePotential::perform(const readdy::model::
 
 
     for (const auto &angle : potential->getAngles()) {
-        auto &e1 = data->entry_at(particleIndices.at(angle.idx1));
-        auto &e2 = data->entry_at(particleIndices.at(angle.idx2));
-        auto &e3 = data->entry_at(particleIndices.at(angle.idx3));
+        auto e1 = data->entry_at(particleIndices.at(angle.idx1));
+        auto e2 = data->entry_at(particleIndices.at(angle.idx2));
+        auto e3 = data->entry_at(particleIndices.at(angle.idx3));
         const auto x_ji = d(e2.pos, e1.pos);
         const auto x_jk = d(e2.pos, e3.pos);
         energy += potential->calculateEnergy(x_ji, x_jk, angle);
@@ -97,10 +97,10 @@ readdy::scalar CPUCalculateCosineDihedralPotential::perform(const readdy::model:
     const auto &d = context->shortestDifferenceFun();
 
     for (const auto &dih : potential->getDihedrals()) {
-        auto &e_i = data->entry_at(particleIndices.at(dih.idx1));
-        auto &e_j = data->entry_at(particleIndices.at(dih.idx2));
-        auto &e_k = data->entry_at(particleIndices.at(dih.idx3));
-        auto &e_l = data->entry_at(particleIndices.at(dih.idx4));
+        auto e_i = data->entry_at(particleIndices.at(dih.idx1));
+        auto e_j = data->entry_at(particleIndices.at(dih.idx2));
+        auto e_k = data->entry_at(particleIndices.at(dih.idx3));
+        auto e_l = data->entry_at(particleIndices.at(dih.idx4));
         const auto x_ji = d(e_j.pos, e_i.pos);
         const auto x_kj = d(e_k.pos, e_j.pos);
         const auto x_kl = d(e_k.pos, e_l.pos);
@@ -121,7 +121,9 @@ CPUChangeParticleType::CPUChangeParticleType(CPUStateModel::data_type *const dat
 void CPUChangeParticleType::execute() {
     const auto idx = topology->getParticles().at(_vertex->particleIndex);
     _vertex->setParticleType(previous_type);
-    std::swap(data->entry_at(idx).type, previous_type);
+    const auto type = data->entry_at(idx).type;
+    data->setType(idx, previous_type);
+    previous_type = type;
 }
 
 void CPUChangeParticleType::undo() {
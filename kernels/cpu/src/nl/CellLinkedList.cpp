@@ -30,39 +30,91 @@
  * @copyright GNU Lesser General Public License v3.0
  */
 
+#include <numeric>
+#include <unordered_map>
 #include <readdy/kernel/cpu/nl/CellLinkedList.h>
 #include <readdy/common/numeric.h>
+#include <readdy/common/boundary_condition_operations.h>
 
 namespace readdy {
 namespace kernel {
 namespace cpu {
 namespace nl {
 
+constexpr std::uint8_t CellLinkedList::nColors;
+
 CellLinkedList::CellLinkedList(data_type &data, const readdy::model::Context &context,
                                thread_pool &pool)
         : _data(data), _context(context), _pool(pool) {}
 
 
 void CellLinkedList::setUp(scalar skin, cell_radius_type radius, const util::PerformanceNode &node) {
-    if (!_is_set_up || _skin != skin || _radius != radius) {
+    if (!_is_set_up || _skin != skin || _radius != radius || _smallCutoff != _setUpSmallCutoff
+        || _sparse != _setUpSparse) {
         auto t = node.timeit();
 
         _skin = skin;
         _radius = radius;
+        _setUpSmallCutoff = _smallCutoff;
+        _setUpSparse = _sparse;
         _max_cutoff = _context.get().calculateMaxCutoff();
+        auto cellCutoff = _max_cutoff;
+        _multiResolution = false;
+        _largeTypes.clear();
+        if (!_sparse && _smallCutoff > 0 && _smallCutoff < _max_cutoff) {
+            // The cells are sized for the small cutoff, which suffices for pairs of small types. Of each pair that
+            // interacts further, the type with the larger overall cutoff is declared large, large types are searched
+            // over more cells.
+            const auto pairCutoffs = _context.get().calculateMaxCutoffs();
+            std::unordered_map<particle_type_type, scalar> typeCutoffs;
+            for (const auto &entry : pairCutoffs) {
+                for (auto type : {std::get<0>(entry.first), std::get<1>(entry.first)}) {
+                    typeCutoffs[type] = std::max(typeCutoffs[type], entry.second);
+                }
+            }
+            for (const auto &entry : pairCutoffs) {
+                const auto type1 = std::get<0>(entry.first);
+                const auto type2 = std::get<1>(entry.first);
+                if (entry.second > _smallCutoff && !largeType(type1) && !largeType(type2)) {
+                    const auto type = typeCutoffs[type1] >= typeCutoffs[type2] ? type1 : type2;
+                    if (type >= _largeTypes.size()) {
+                        _largeTypes.resize(type + 1_z, false);
+                    }
+                    _largeTypes[type] = true;
+                    _multiResolution = true;
+                }
+            }
+            if (_multiResolution) {
+                cellCutoff = _smallCutoff;
+            }
+        }
         if (_max_cutoff > 0) {
             auto size = _context.get().boxSize();
-            auto desiredWidth = static_cast<scalar>((_max_cutoff + _skin) / static_cast<scalar>(radius));
+            auto desiredWidth = static_cast<scalar>((cellCutoff + _skin) / static_cast<scalar>(radius));
             std::array<std::size_t, 3> dims{};
             for (int i = 0; i < 3; ++i) {
-                dims[i] = static_cast<unsigned int>(std::max(1., std::floor(size[i] / desiredWidth)));
+                dims[i] = static_cast<unsigned int>(std::max(c_::one, std::floor(size[i] / desiredWidth)));
                 _cellSize[i] = size[i] / static_cast<scalar>(dims[i]);
+                _largeRadius[i] = radius;
+                if (_multiResolution) {
+                    const auto largeRadius = static_cast<std::size_t>(std::ceil((_max_cutoff + _skin) / _cellSize[i]));
+                    _largeRadius[i] = std::max(_largeRadius[i], largeRadius);
+                }
             }
 
             _cellIndex = util::Index3D(dims[0], dims[1], dims[2]);
 
-            {
-                // set up cell adjacency list
+            // The periodic image shift of each adjacent cell is unique as long as the stencil does not wrap around
+            // onto itself, see imageShift().
+            _imageShiftsResolved = true;
+            for (int d = 0; d < 3; ++d) {
+                if (_context.get().periodicBoundaryConditions()[d] && _cellIndex[d] < 2_z * radius + 1) {
+                    _imageShiftsResolved = false;
+                }
+            }
+
+            if (!_sparse) {
+                // set up cell adjacency list, in sparse mode this happens for the occupied cells in setUpSparseCells
                 auto t2 = node.subnode("setUpCellNeighbors").timeit();
                 std::array<std::size_t, 3> nNeighbors{{_cellIndex[0], _cellIndex[1], _cellIndex[2]}};
                 for (int i = 0; i < 3; ++i) {
@@ -126,8 +178,19 @@ void CellLinkedList::setUp(scalar skin, cell_radius_type radius, const util::Per
                         }
                     }
                 }
+                _cellNeighborShifts.assign(_cellNeighborsContent.size(), Vec3(0, 0, 0));
+                if (_imageShiftsResolved) {
+                    for (auto cell = 0_z; cell < _cellIndex.size(); ++cell) {
+                        auto itShift = &_cellNeighborShifts.at(_cellNeighbors(cell, 1_z));
+                        for (auto it = neighborsBegin(cell); it != neighborsEnd(cell); ++it, ++itShift) {
+                            *itShift = imageShift(cell, *it);
+                        }
+                    }
+                }
             }
 
+            setUpColoring(node.subnode("setUpCellColoring"));
+
             if (_max_cutoff > 0) {
                 setUpBins(node.subnode("setUpBins"));
             }
@@ -137,100 +200,576 @@ void CellLinkedList::setUp(scalar skin, cell_radius_type radius, const util::Per
     }
 }
 
+void CellLinkedList::setUpColoring(const util::PerformanceNode &node) {
+    auto t = node.timeit();
+    // Partition each axis into blocks that are at least 2*radius cells wide. A half-shell traversal starting in a block
+    // only touches cells within radius of that block, so two blocks are independent as soon as there is another
+    // block between them along one axis. Coloring by the parity of the block coordinates achieves that, provided that
+    // periodic axes have an even number of blocks (or just one block).
+    const auto &pbc = _context.get().periodicBoundaryConditions();
+    // particles of large types reach _largeRadius cells
+    auto &boundaries = _blockBoundaries;
+    for (int d = 0; d < 3; ++d) {
+        const auto minWidth = std::max(2 * _largeRadius[d], 1_z);
+        const auto nCellsAxis = _cellIndex[d];
+        auto nBlocks = std::max(static_cast<std::size_t>(1), nCellsAxis / minWidth);
+        if (pbc[d] && nBlocks > 1 && nBlocks % 2 != 0) {
+            --nBlocks;
+        }
+        boundaries[d].resize(nBlocks + 1);
+        for (std::size_t s = 0; s <= nBlocks; ++s) {
+            boundaries[d][s] = s * nCellsAxis / nBlocks;
+        }
+    }
+    for (auto &blocks : _coloredBlocks) {
+        blocks.clear();
+    }
+    if (_sparse) {
+        // only blocks that contain occupied cells are materialized, see setUpSparseCells
+        return;
+    }
+    for (std::size_t s0 = 0; s0 < boundaries[0].size() - 1; ++s0) {
+        for (std::size_t s1 = 0; s1 < boundaries[1].size() - 1; ++s1) {
+            for (std::size_t s2 = 0; s2 < boundaries[2].size() - 1; ++s2) {
+                const auto color = (s0 & 1) | (s1 & 1) << 1 | (s2 & 1) << 2;
+                CellBlock block{};
+                block.begin = {{boundaries[0][s0], boundaries[1][s1], boundaries[2][s2]}};
+                block.end = {{boundaries[0][s0 + 1], boundaries[1][s1 + 1], boundaries[2][s2 + 1]}};
+                _coloredBlocks.at(color).push_back(block);
+            }
+        }
+    }
+}
+
+Vec3 CellLinkedList::imageShift(std::size_t cell, std::size_t neighborCell) const {
+    // an adjacent cell that is further away than the radius in cell coordinates was reached through the periodic
+    // boundary
+    const auto &size = _context.get().boxSize();
+    const auto coords = _cellIndex.inverse(cell);
+    const auto neighborCoords = _cellIndex.inverse(neighborCell);
+    const auto r = static_cast<std::ptrdiff_t>(_radius);
+    Vec3 shift{0, 0, 0};
+    for (int d = 0; d < 3; ++d) {
+        const auto delta = static_cast<std::ptrdiff_t>(neighborCoords[d]) - static_cast<std::ptrdiff_t>(coords[d]);
+        if (delta > r) {
+            shift[d] = -size[d];
+        } else if (delta < -r) {
+            shift[d] = size[d];
+        }
+    }
+    return shift;
+}
+
+void CellLinkedList::adjacentSlots(std::size_t gridCell, std::vector<std::size_t> &slots) const {
+    slots.clear();
+    const auto &pbc = _context.get().periodicBoundaryConditions();
+    const auto center = _cellIndex.inverse(gridCell);
+    const auto r = static_cast<std::ptrdiff_t>(_radius);
+    std::array<std::ptrdiff_t, 3> coords{};
+    for (auto di = -r; di <= r; ++di) {
+        for (auto dj = -r; dj <= r; ++dj) {
+            for (auto dk = -r; dk <= r; ++dk) {
+                const std::array<std::ptrdiff_t, 3> delta{{di, dj, dk}};
+                bool inside = true;
+                for (int d = 0; d < 3; ++d) {
+                    const auto n = static_cast<std::ptrdiff_t>(_cellIndex[d]);
+                    coords[d] = static_cast<std::ptrdiff_t>(center[d]) + delta[d];
+                    if (pbc[d]) {
+                        coords[d] = (coords[d] % n + n) % n;
+                    } else if (coords[d] < 0 || coords[d] >= n) {
+                        inside = false;
+                    }
+                }
+                if (inside) {
+                    const auto it = _slotOfCell.find(_cellIndex(static_cast<std::size_t>(coords[0]),
+                                                                static_cast<std::size_t>(coords[1]),
+                                                                static_cast<std::size_t>(coords[2])));
+                    if (it != _slotOfCell.end()) {
+                        slots.push_back(it->second);
+                    }
+                }
+            }
+        }
+    }
+    std::sort(slots.begin(), slots.end());
+    slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+    const auto self = _slotOfCell.find(gridCell);
+    if (self != _slotOfCell.end()) {
+        slots.erase(std::remove(slots.begin(), slots.end(), self->second), slots.end());
+    }
+}
+
+void CellLinkedList::setUpSparseCells(const util::PerformanceNode &node) {
+    auto t = node.timeit();
+    const auto &data = _data.get();
+    {
+        // the occupied cells in ascending order, their positions in this list are the cell indices of the bins
+        auto tSlots = node.subnode("slots").timeit();
+        _cellOfSlot.clear();
+        for (auto index = 0_z; index < data.size(); ++index) {
+            if (!data.entry_at(index).deactivated) {
+                _cellOfSlot.push_back(gridCellOfParticle(index));
+            }
+        }
+        std::sort(_cellOfSlot.begin(), _cellOfSlot.end());
+        _cellOfSlot.erase(std::unique(_cellOfSlot.begin(), _cellOfSlot.end()), _cellOfSlot.end());
+        _slotOfCell.clear();
+        _slotOfCell.reserve(_cellOfSlot.size());
+        for (auto slot = 0_z; slot < _cellOfSlot.size(); ++slot) {
+            _slotOfCell.emplace(_cellOfSlot[slot], slot);
+        }
+    }
+    const auto nSlots = _cellOfSlot.size();
+    {
+        // only occupied adjacent cells are listed, as slots they keep the ascending order of the grid cells
+        auto tAdjacency = node.subnode("setUpCellNeighbors").timeit();
+        const auto nAdjacentCells = (2_z * _radius + 1) * (2_z * _radius + 1) * (2_z * _radius + 1);
+        _cellNeighbors = util::Index2D(nSlots, 1 + nAdjacentCells);
+        _cellNeighborsContent.assign(_cellNeighbors.size(), 0);
+        _cellNeighborShifts.assign(_cellNeighbors.size(), Vec3(0, 0, 0));
+        std::vector<std::size_t> adj;
+        adj.reserve(nAdjacentCells);
+        for (auto slot = 0_z; slot < nSlots; ++slot) {
+            adjacentSlots(_cellOfSlot[slot], adj);
+            const auto begin = _cellNeighbors(slot, 0_z);
+            _cellNeighborsContent[begin] = adj.size();
+            for (auto n = 0_z; n < adj.size(); ++n) {
+                _cellNeighborsContent[begin + 1 + n] = adj[n];
+                if (_imageShiftsResolved) {
+                    _cellNeighborShifts[begin + 1 + n] = imageShift(_cellOfSlot[slot], _cellOfSlot[adj[n]]);
+                }
+            }
+        }
+    }
+    {
+        // group the occupied cells by the block they fall into, blocks without occupied cells are left out
+        auto tBlocks = node.subnode("setUpCellColoring").timeit();
+        const auto &boundaries = _blockBoundaries;
+        const util::Index3D blockIndex(boundaries[0].size() - 1, boundaries[1].size() - 1, boundaries[2].size() - 1);
+        std::vector<std::pair<std::size_t, std::size_t>> blockOfSlot;
+        blockOfSlot.reserve(nSlots);
+        for (auto slot = 0_z; slot < nSlots; ++slot) {
+            const auto coords = _cellIndex.inverse(_cellOfSlot[slot]);
+            std::array<std::size_t, 3> block{};
+            for (int d = 0; d < 3; ++d) {
+                block[d] = static_cast<std::size_t>(
+                        std::upper_bound(boundaries[d].begin(), boundaries[d].end(), coords[d])
+                        - boundaries[d].begin() - 1);
+            }
+            blockOfSlot.emplace_back(blockIndex(block[0], block[1], block[2]), slot);
+        }
+        std::sort(blockOfSlot.begin(), blockOfSlot.end());
+        _blockCells.resize(nSlots);
+        for (auto &blocks : _coloredBlocks) {
+            blocks.clear();
+        }
+        for (auto it = 0_z; it < nSlots;) {
+            const auto s = blockIndex.inverse(blockOfSlot[it].first);
+            CellBlock block{};
+            block.begin = {{boundaries[0][s[0]], boundaries[1][s[1]], boundaries[2][s[2]]}};
+            block.end = {{boundaries[0][s[0] + 1], boundaries[1][s[1] + 1], boundaries[2][s[2] + 1]}};
+            block.cellsBegin = it;
+            for (; it < nSlots && blockOfSlot[it].first == blockOfSlot[block.cellsBegin].first; ++it) {
+                _blockCells[it] = blockOfSlot[it].second;
+            }
+            block.cellsEnd = it;
+            const auto color = (s[0] & 1) | (s[1] & 1) << 1 | (s[2] & 1) << 2;
+            _coloredBlocks.at(color).push_back(block);
+        }
+    }
+}
+
 CompactCellLinkedList::CompactCellLinkedList(data_type &data, const readdy::model::Context &context,
                                              thread_pool &pool) : CellLinkedList(data, context, pool) {}
 
 template<>
 void CompactCellLinkedList::fillBins<true>(const util::PerformanceNode &node) {
     auto t = node.timeit();
-    const auto &boxSize = _context.get().boxSize();
     std::size_t pidx = 1;
     for (const auto &entry : _data.get()) {
         if (!entry.deactivated) {
-            const auto i = static_cast<std::size_t>(std::floor((entry.pos.x + .5 * boxSize[0]) / _cellSize.x));
-            const auto j = static_cast<std::size_t>(std::floor((entry.pos.y + .5 * boxSize[1]) / _cellSize.y));
-            const auto k = static_cast<std::size_t>(std::floor((entry.pos.z + .5 * boxSize[2]) / _cellSize.z));
-            const auto cellIndex = _cellIndex(i, j, k);
+            const auto cellIndex = cellOfParticle(pidx - 1);
             _list[pidx] = *_head.at(cellIndex);
             *_head[cellIndex] = pidx;
+            _binOf[pidx - 1] = cellIndex;
         }
         ++pidx;
     }
 }
 
-template<>
-void CompactCellLinkedList::fillBins<false>(const util::PerformanceNode &node) {
+namespace {
+/**
+ * Splits [0, n) into at most nChunks contiguous chunks of equal size and processes them on the pool.
+ * @param worker invoked with (chunk, begin, end)
+ */
+template<typename Worker>
+void forEachChunk(thread_pool &pool, std::size_t n, std::size_t nChunks, const Worker &worker) {
+    const auto chunkSize = (n + nChunks - 1) / nChunks;
+    std::vector<util::thread::joining_future<void>> futures;
+    futures.reserve(nChunks);
+    for (auto chunk = 0_z; chunk < nChunks && chunk * chunkSize < n; ++chunk) {
+        futures.emplace_back(pool.push([&worker](std::size_t, std::size_t c, std::size_t begin, std::size_t end) {
+            worker(c, begin, end);
+        }, chunk, chunk * chunkSize, std::min(n, (chunk + 1) * chunkSize)));
+    }
+}
+}
+
+void CompactCellLinkedList::countingSort(const util::PerformanceNode &node) {
     auto t = node.timeit();
+    const auto &data = _data.get();
+    auto &pool = _pool.get();
+    const auto nParticles = data.size();
+    const auto nCells = this->nCells();
+    // each chunk of particles has its own histogram, their number is bounded so that the histograms stay small
+    // compared to the particle data
+    const auto nChunks = std::max(1_z, std::min(pool.size(), 8 * nParticles / std::max(nCells, 1_z)));
+    _histograms.assign(nChunks * nCells, 0);
+    _cellOffsets.assign(nCells + 1, 0);
+    {
+        // count the particles per cell and chunk, deactivated entries are assigned to the past-the-end cell
+        auto tCount = node.subnode("count").timeit();
+        forEachChunk(pool, nParticles, nChunks, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+            auto histogram = _histograms.begin() + chunk * nCells;
+            for (auto index = begin; index < end; ++index) {
+                if (!data.entry_at(index).deactivated) {
+                    const auto cell = cellOfParticle(index);
+                    _binOf[index] = cell;
+                    ++histogram[cell];
+                } else {
+                    _binOf[index] = nCells;
+                }
+            }
+        });
+    }
+    {
+        // prefix sum over cells, then over the chunks of each cell
+        auto tPrefix = node.subnode("prefix").timeit();
+        forEachChunk(pool, nCells, pool.size(), [&](std::size_t, std::size_t begin, std::size_t end) {
+            for (auto cell = begin; cell < end; ++cell) {
+                for (auto chunk = 0_z; chunk < nChunks; ++chunk) {
+                    _cellOffsets[cell + 1] += _histograms[chunk * nCells + cell];
+                }
+            }
+        });
+        std::partial_sum(_cellOffsets.begin(), _cellOffsets.end(), _cellOffsets.begin());
+        forEachChunk(pool, nCells, pool.size(), [&](std::size_t, std::size_t begin, std::size_t end) {
+            for (auto cell = begin; cell < end; ++cell) {
+                auto offset = _cellOffsets[cell];
+                for (auto chunk = 0_z; chunk < nChunks; ++chunk) {
+                    const auto count = _histograms[chunk * nCells + cell];
+                    _histograms[chunk * nCells + cell] = offset;
+                    offset += count;
+                }
+            }
+        });
+    }
+    {
+        // scatter, the chunks are processed in order, so each cell's contents are in ascending order
+        auto tScatter = node.subnode("scatter").timeit();
+        _cellContents.resize(_cellOffsets.back());
+        forEachChunk(pool, nParticles, nChunks, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+            auto offsets = _histograms.begin() + chunk * nCells;
+            for (auto index = begin; index < end; ++index) {
+                const auto cell = _binOf[index];
+                if (cell != nCells) {
+                    _cellContents[offsets[cell]++] = index;
+                }
+            }
+        });
+    }
+}
 
-    {/*
-        auto thilb = node.subnode("hilbert").timeit();
-        static int i = 0;
-        if(i % 100 == 0) {
-            _data.get().hilbertSort(_max_cutoff + _skin);
-            i = 0;
+void CompactCellLinkedList::linkCellContents(const util::PerformanceNode &node) {
+    auto t = node.timeit();
+    forEachChunk(_pool.get(), nCells(), _pool.get().size(), [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (auto cell = begin; cell < end; ++cell) {
+            const auto first = cellBegin(cell);
+            const auto last = cellEnd(cell);
+            *_head[cell] = first < last ? _cellContents[first] + 1 : 0;
+            for (auto k = first; k < last; ++k) {
+                _list[_cellContents[k] + 1] = k + 1 < last ? _cellContents[k + 1] + 1 : 0;
+                _binOf[_cellContents[k]] = cell;
+            }
         }
-        ++i;
-    */}
+    });
+}
 
-    const auto &boxSize = _context.get().boxSize();
-    const auto &data = _data.get();
-    const auto grainSize = data.size() / _pool.get().size();
-    const auto cellSize = _cellSize;
-    const auto &cellIndex = _cellIndex;
-
-    auto &list = _list;
-    auto &head = _head;
-
-    auto worker = [&data, &cellIndex, cellSize, &list, &head, boxSize]
-            (std::size_t tid, std::size_t begin_pidx, std::size_t end_pidx) {
-        auto it = data.begin() + begin_pidx - 1;
-        auto pidx = begin_pidx;
-        while (it != data.begin() + end_pidx - 1) {
-            const auto &entry = *it;
-            if (!entry.deactivated) {
-                const auto i = static_cast<std::size_t>(std::floor((entry.pos.x + .5 * boxSize[0]) / cellSize.x));
-                const auto j = static_cast<std::size_t>(std::floor((entry.pos.y + .5 * boxSize[1]) / cellSize.y));
-                const auto k = static_cast<std::size_t>(std::floor((entry.pos.z + .5 * boxSize[2]) / cellSize.z));
-                const auto cix = cellIndex(i, j, k);
-                auto &atomic = *head.at(cix);
-                // perform CAS
-                auto currentHead = atomic.load();
-                while (!atomic.compare_exchange_weak(currentHead, pidx)) {}
-                list[pidx] = currentHead;
-            }
-            ++pidx;
-            ++it;
-        }
-    };
+template<>
+void CompactCellLinkedList::fillBins<false>(const util::PerformanceNode &node) {
+    auto t = node.timeit();
+    countingSort(node.subnode("countingSort"));
+    linkCellContents(node.subnode("link"));
+    _contiguous = true;
+}
 
-    std::vector<util::thread::joining_future<void>> futures;
-    futures.reserve(_pool.get().size());
-    auto it = 1_z;
-    for (auto i = 0_z; i < _pool.get().size() - 1; ++i) {
-        auto itNext = it + grainSize;
-        if(it != itNext) futures.emplace_back(_pool.get().push(worker, it, itNext));
-        it = itNext;
+void CompactCellLinkedList::fillSortedBins(const util::PerformanceNode &node) {
+    auto t = node.timeit();
+    auto &data = _data.get();
+    const auto nParticles = data.size();
+    countingSort(node.subnode("countingSort"));
+    {
+        // the particles move to their position in the cell contents, deactivated entries to the back
+        auto tReorder = node.subnode("reorder").timeit();
+        const auto nActive = _cellContents.size();
+        std::vector<std::size_t> newIndices(nParticles);
+        for (auto k = 0_z; k < nActive; ++k) {
+            newIndices[_cellContents[k]] = k;
+        }
+        auto next = nActive;
+        for (auto index = 0_z; index < nParticles; ++index) {
+            if (_binOf[index] == nCells()) {
+                newIndices[index] = next++;
+            }
+        }
+        data.reorder(std::move(newIndices));
+        std::iota(_cellContents.begin(), _cellContents.end(), 0_z);
+        std::fill(_binOf.begin() + nActive, _binOf.end(), nCells());
     }
-    futures.emplace_back(_pool.get().push(worker, it, _data.get().size()+1));
+    linkCellContents(node.subnode("link"));
+    _contiguous = true;
 }
 
 void CompactCellLinkedList::setUpBins(const util::PerformanceNode &node) {
+    // the Verlet lists refer to the bins
+    _verletValid = false;
+    _contiguous = false;
+    ++_generation;
     if (_max_cutoff > 0) {
         auto t = node.timeit();
+        ++_binsSinceSort;
+        if (_data.get().compactionDue()) {
+            // fires the reorder signal, so that topologies can update their particle indices
+            auto tc = node.subnode("compact").timeit();
+            _data.get().compact();
+        }
+        if (hilbertSortDue()) {
+            // fires the reorder signal, so that topologies can update their particle indices
+            auto ts = node.subnode("hilbertSort").timeit();
+            _data.get().hilbertSort(std::min({_cellSize.x, _cellSize.y, _cellSize.z}));
+            _binsSinceSort = 0;
+        }
+        if (_sparse) {
+            setUpSparseCells(node.subnode("setUpSparseCells"));
+        }
         {
             auto tt = node.subnode("allocate").timeit();
             auto nParticles = _data.get().size();
             _head.clear();
-            _head.resize(_cellIndex.size());
+            _head.resize(nCells());
             _list.resize(0);
             _list.resize(nParticles + 1);
+            _binOf.assign(nParticles, nCells());
         }
-        if (_serial) {
+        if (_sortByCell) {
+            fillSortedBins(node.subnode("fillSortedBins"));
+        } else if (_serial) {
             fillBins<true>(node.subnode("fillBins serial"));
         } else {
             fillBins<false>(node.subnode("fillBins parallel"));
         }
+        if (_multiResolution) {
+            setUpLargeParticles(node.subnode("setUpLargeParticles"));
+        }
+        if (_hilbertSortThreshold < c_::one) {
+            _scatter = scatter();
+        }
+        _binsValid = true;
+        _data.get().clearEdits();
+    }
+}
+
+void CompactCellLinkedList::applyEdits(const util::PerformanceNode &node) {
+    auto t = node.timeit();
+    auto &data = _data.get();
+    // new entries may have been appended
+    _list.resize(data.size() + 1);
+    _binOf.resize(data.size(), nCells());
+    if (_multiResolution) {
+        _large.resize(data.size(), false);
+        _largeList.resize(data.size() + 1);
+    }
+    for (auto index : data.edits()) {
+        if (_multiResolution) {
+            unlinkLarge(index);
+        }
+        unlink(index);
+        const auto &entry = data.entry_at(index);
+        if (!entry.deactivated) {
+            const auto cell = cellOfParticle(index);
+            auto &head = *_head.at(cell);
+            _list[index + 1] = head.load();
+            head = index + 1;
+            _binOf[index] = cell;
+            if (_multiResolution && largeType(entry.type)) {
+                linkLarge(index, cell);
+            }
+        }
+    }
+    data.clearEdits();
+    // the Verlet lists do not know about the edited particles and the cells are no longer contiguous
+    _verletValid = false;
+    _contiguous = false;
+}
+
+void CompactCellLinkedList::unlink(std::size_t index) {
+    const auto cell = _binOf[index];
+    if (cell == nCells()) {
+        return;
+    }
+    // the list is singly linked, so this is linear in the number of particles in the cell
+    const auto pidx = index + 1;
+    auto &head = *_head.at(cell);
+    if (head.load() == pidx) {
+        head = _list[pidx];
+    } else {
+        auto previous = head.load();
+        while (_list[previous] != pidx) {
+            previous = _list[previous];
+        }
+        _list[previous] = _list[pidx];
+    }
+    _list[pidx] = 0;
+    _binOf[index] = nCells();
+}
+
+void CompactCellLinkedList::setUpLargeParticles(const util::PerformanceNode &node) {
+    auto t = node.timeit();
+    const auto &data = _data.get();
+    _large.assign(data.size(), false);
+    _largeHead.assign(nCells(), 0);
+    _largeList.assign(data.size() + 1, 0);
+    for (auto index = 0_z; index < data.size(); ++index) {
+        const auto &entry = data.entry_at(index);
+        if (!entry.deactivated && largeType(entry.type)) {
+            linkLarge(index, _binOf[index]);
+        }
+    }
+}
+
+void CompactCellLinkedList::linkLarge(std::size_t index, std::size_t cell) {
+    _large[index] = true;
+    _largeList[index + 1] = _largeHead[cell];
+    _largeHead[cell] = index + 1;
+}
+
+void CompactCellLinkedList::unlinkLarge(std::size_t index) {
+    if (!_large[index]) {
+        return;
+    }
+    // large particles are linked into the cell they are binned in
+    const auto pidx = index + 1;
+    auto &head = _largeHead[_binOf[index]];
+    if (head == pidx) {
+        head = _largeList[pidx];
+    } else {
+        auto previous = head;
+        while (_largeList[previous] != pidx) {
+            previous = _largeList[previous];
+        }
+        _largeList[previous] = _largeList[pidx];
+    }
+    _largeList[pidx] = 0;
+    _large[index] = false;
+}
+
+bool CompactCellLinkedList::hilbertSortDue() const {
+    return (_hilbertSortInterval > 0 && _binsSinceSort >= _hilbertSortInterval) || _scatter > _hilbertSortThreshold;
+}
+
+scalar CompactCellLinkedList::scatter() const {
+    std::size_t nBinned = 0;
+    std::size_t nJumps = 0;
+    auto previous = nCells();
+    for (auto cell : _binOf) {
+        if (cell != nCells()) {
+            ++nBinned;
+            if (cell != previous) {
+                ++nJumps;
+                previous = cell;
+            }
+        }
+    }
+    return nBinned > 0 ? static_cast<scalar>(nJumps) / static_cast<scalar>(nBinned) : c_::zero;
+}
+
+bool CompactCellLinkedList::displacedTooFar(const util::PerformanceNode &node) const {
+    auto t = node.timeit();
+    const auto &data = _data.get();
+    if (data.size() != _verletReference.size()) {
+        return true;
+    }
+    const auto &context = _context.get();
+    const auto &box = context.boxSize();
+    const auto maxDisplacementSquared = c_::half * _skin * c_::half * _skin;
+    return bcs::dispatchPeriodicBoundaries(context.periodicBoundaryConditions(), [&](auto boundaries) {
+        using boundaries_t = decltype(boundaries);
+        auto itRef = _verletReference.begin();
+        for (auto it = data.begin(); it != data.end(); ++it, ++itRef) {
+            if (it->deactivated != itRef->deactivated) {
+                return true;
+            }
+            if (!it->deactivated && (it->id != itRef->id
+                                     || boundaries_t::distSquared(it->pos, itRef->pos, box) > maxDisplacementSquared)) {
+                return true;
+            }
+            // in multi-resolution mode the half shell of a particle depends on whether its type is large
+            if (!it->deactivated && _multiResolution && largeType(it->type) != largeType(itRef->type)) {
+                return true;
+            }
+        }
+        return false;
+    });
+}
+
+void CompactCellLinkedList::setUpVerletList(const util::PerformanceNode &node) {
+    auto t = node.timeit();
+    const auto &data = _data.get();
+    {
+        auto tRef = node.subnode("reference").timeit();
+        _verletReference.resize(data.size());
+        auto itRef = _verletReference.begin();
+        for (auto it = data.begin(); it != data.end(); ++it, ++itRef) {
+            *itRef = {it->pos, it->id, it->type, it->deactivated != 0};
+        }
+    }
+    _verletList.resize(data.size());
+    if (_max_cutoff > 0) {
+        auto tFill = node.subnode("fill").timeit();
+        const auto &context = _context.get();
+        const auto &box = context.boxSize();
+        const auto radiusSquared = (_max_cutoff + _skin) * (_max_cutoff + _skin);
+        bcs::dispatchPeriodicBoundaries(context.periodicBoundaryConditions(), [&](auto boundaries) {
+            using boundaries_t = decltype(boundaries);
+            // each particle is contained in exactly one cell, so the lists of different cells can be filled concurrently
+            auto worker = [&](std::size_t, std::size_t cellsBegin, std::size_t cellsEnd) {
+                for (auto cell = cellsBegin; cell < cellsEnd; ++cell) {
+                    for (auto it = particlesBegin(cell); it != particlesEnd(cell); ++it) {
+                        auto &neighbors = _verletList[*it];
+                        neighbors.clear();
+                        const auto &pos = data.entry_at(*it).pos;
+                        forEachHalfNeighbor(it, cell, [&](auto neighbor) {
+                            if (boundaries_t::distSquared(pos, data.entry_at(neighbor).pos, box) < radiusSquared) {
+                                neighbors.push_back(neighbor);
+                            }
+                        });
+                    }
+                }
+            };
+            auto &pool = _pool.get();
+            const auto grainSize = nCells() / pool.size();
+            std::vector<util::thread::joining_future<void>> futures;
+            futures.reserve(pool.size());
+            auto it = 0_z;
+            for (auto i = 0_z; i < pool.size() - 1; ++i) {
+                auto itNext = it + grainSize;
+                if (it != itNext) futures.emplace_back(pool.push(worker, it, itNext));
+                it = itNext;
+            }
+            if (it != nCells()) futures.emplace_back(pool.push(worker, it, nCells()));
+        });
     }
+    _verletValid = true;
 }
 
 }
@@ -0,0 +1,151 @@
+/********************************************************************
+ * Copyright © 2018 Computational Molecular Biology Group,          *
+ *                  Freie Universität Berlin (GER)                  *
+ *                                                                  *
+ * This file is part of ReaDDy.                                     *
+ *                                                                  *
+ * ReaDDy is free software: you can redistribute it and/or modify   *
+ * it under the terms of the GNU Lesser General Public License as   *
+ * published by the Free Software Foundation, either version 3 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU Lesser General Public License for more details.              *
+ *                                                                  *
+ * You should have received a copy of the GNU Lesser General        *
+ * Public License along with this program. If not, see              *
+ * <http://www.gnu.org/licenses/>.                                  *
+ ********************************************************************/
+
+
+
+
+/**
+ * @file PairList.cpp
+ * @brief Implementation of the cached pair list.
+ * @author clonker
+ * @date 14.02.18
+ */
+
+#include <readdy/kernel/cpu/nl/PairList.h>
+#include <readdy/common/boundary_condition_operations.h>
+
+namespace readdy {
+namespace kernel {
+namespace cpu {
+namespace nl {
+
+namespace {
+template<typename Boundaries>
+void collectPairs(std::size_t, const CellLinkedList::CellBlock *begin, const CellLinkedList::CellBlock *end,
+                  PairList::pairs *out, const CompactCellLinkedList &neighborList,
+                  const std::vector<char> &interacting, std::size_t nTypes, const model::Context &context) {
+    const auto &data = neighborList.data();
+    const auto &box = context.boxSize();
+    const auto cutoffSquared = neighborList.maxCutoff() * neighborList.maxCutoff();
+    for (auto block = begin; block != end; ++block, ++out) {
+        out->clear();
+        neighborList.forEachCellInBlock(*block, [&](std::size_t cell) {
+            for (auto particleIt = neighborList.particlesBegin(cell);
+                 particleIt != neighborList.particlesEnd(cell); ++particleIt) {
+                const auto &entry = data.entry_at(*particleIt);
+                if (entry.deactivated || entry.type >= nTypes) continue;
+                const auto row = entry.type * nTypes;
+                neighborList.forEachHalfNeighbor(particleIt, cell, [&](std::size_t neighborIndex) {
+                    const auto &neighbor = data.entry_at(neighborIndex);
+                    if (neighbor.deactivated || neighbor.type >= nTypes || !interacting[row + neighbor.type]) {
+                        return;
+                    }
+                    const auto x_ij = Boundaries::shortestDifference(entry.pos, neighbor.pos, box);
+                    const auto distSquared = x_ij * x_ij;
+                    if (distSquared < cutoffSquared) {
+                        out->push_back({*particleIt, neighborIndex, distSquared, x_ij});
+                    }
+                });
+            }
+        });
+    }
+}
+}
+
+PairList::PairList(const CompactCellLinkedList &neighborList, const model::Context &context, thread_pool &pool)
+        : _neighborList(neighborList), _context(context), _pool(pool) {}
+
+std::size_t PairList::size() const {
+    std::size_t result = 0;
+    for (const auto &block : _blockPairs) {
+        result += block.size();
+    }
+    return result;
+}
+
+void PairList::update(const util::PerformanceNode &node) {
+    if (upToDate()) return;
+    auto t = node.timeit();
+    const auto &neighborList = _neighborList.get();
+    const auto &context = _context.get();
+
+    std::size_t nTypes = 0;
+    for (const auto &entry : context.particle_types().typeMapping()) {
+        nTypes = std::max(nTypes, static_cast<std::size_t>(entry.second) + 1);
+    }
+    {
+        const auto &pot2 = context.potentials().tableOrder2();
+        const auto &reactions = context.reactions();
+        _interacting.assign(nTypes * nTypes, false);
+        for (std::size_t t1 = 0; t1 < nTypes; ++t1) {
+            for (std::size_t t2 = 0; t2 < nTypes; ++t2) {
+                const auto type1 = static_cast<particle_type_type>(t1);
+                const auto type2 = static_cast<particle_type_type>(t2);
+                _interacting[t1 * nTypes + t2] = pot2.begin(type1, type2) != pot2.end(type1, type2)
+                                                 || !reactions.order2ByType(type1, type2).empty()
+                                                 || !reactions.order2ByType(type2, type1).empty();
+            }
+        }
+    }
+
+    _colorOffsets[0] = 0;
+    for (std::uint8_t color = 0; color < CellLinkedList::nColors; ++color) {
+        _colorOffsets[color + 1] = _colorOffsets[color] + neighborList.blocksOfColor(color).size();
+    }
+    _blockPairs.resize(_colorOffsets.back());
+
+    if (neighborList.maxCutoff() > 0) {
+        const auto collect = bcs::dispatchPeriodicBoundaries(context.periodicBoundaryConditions(), [](auto boundaries) {
+            return &collectPairs<decltype(boundaries)>;
+        });
+        // collecting only reads the particle data, so all blocks can be processed concurrently regardless of color
+        auto &pool = _pool.get();
+        std::vector<util::thread::joining_future<void>> futures;
+        futures.reserve(pool.size() * CellLinkedList::nColors);
+        for (std::uint8_t color = 0; color < CellLinkedList::nColors; ++color) {
+            const auto &blocks = neighborList.blocksOfColor(color);
+            if (blocks.empty()) continue;
+            const auto nTasks = std::min(pool.size(), blocks.size());
+            const auto grainSize = blocks.size() / nTasks;
+            auto it = blocks.data();
+            auto out = _blockPairs.data() + _colorOffsets[color];
+            for (auto task = 0_z; task < nTasks; ++task) {
+                const auto itNext = task == nTasks - 1 ? blocks.data() + blocks.size() : it + grainSize;
+                futures.emplace_back(pool.push(collect, it, itNext, out, std::cref(neighborList),
+                                               std::cref(_interacting), nTypes, std::cref(context)));
+                out += itNext - it;
+                it = itNext;
+            }
+        }
+    } else {
+        for (auto &block : _blockPairs) {
+            block.clear();
+        }
+    }
+
+    _generation = neighborList.generation();
+    _built = true;
+}
+
+}
+}
+}
+}
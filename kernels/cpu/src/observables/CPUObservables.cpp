@@ -32,6 +32,7 @@
 #include <future>
 
 #include <readdy/common/thread/scoped_async.h>
+#include <readdy/common/thread/joining_future.h>
 
 #include <readdy/kernel/cpu/observables/CPUObservables.h>
 #include <readdy/kernel/cpu/CPUKernel.h>
@@ -52,10 +53,13 @@ void CPUPositions::evaluate() {
     if (typesToCount.empty()) {
         result = stateModel.getParticlePositions();
     } else {
-        for (const auto &e : *stateModel.getParticleData()) {
-            if (!e.deactivated &&
-                std::find(typesToCount.begin(), typesToCount.end(), e.type) != typesToCount.end()) {
-                result.push_back(e.pos);
+        const auto &positions = pd->positions();
+        const auto &types = pd->types();
+        const auto &deactivated = pd->deactivated();
+        for (std::size_t index = 0; index < pd->size(); ++index) {
+            if (!deactivated[index] &&
+                std::find(typesToCount.begin(), typesToCount.end(), types[index]) != typesToCount.end()) {
+                result.push_back(positions[index]);
             }
         }
     }
@@ -70,8 +74,6 @@ CPUHistogramAlongAxis::CPUHistogramAlongAxis(CPUKernel *const kernel, unsigned i
 }
 
 void CPUHistogramAlongAxis::evaluate() {
-    using Iter = readdy::kernel::cpu::CPUStateModel::data_type::const_iterator;
-
     std::fill(result.begin(), result.end(), 0);
 
     const auto binBorders = this->binBorders;
@@ -80,15 +82,17 @@ void CPUHistogramAlongAxis::evaluate() {
     const auto axis = this->axis;
     const auto data = kernel->getCPUKernelStateModel().getParticleData();
 
-    std::vector<std::future<result_type>> updates;
-    updates.reserve(kernel->getNThreads());
-    auto worker = [binBorders, typesToCount, resultSize, data, axis](std::size_t, Iter from, Iter to, std::promise<result_type>& update) {
-        result_type resultUpdate;
-        resultUpdate.resize(resultSize);
-
-        for (auto it = from; it != to; ++it) {
-            if (!it->deactivated && typesToCount.find(it->type) != typesToCount.end()) {
-                auto upperBound = std::upper_bound(binBorders.begin(), binBorders.end(), it->pos[axis]);
+    auto worker = [binBorders, typesToCount, resultSize, data, axis](std::size_t tid, std::size_t from,
+                                                                      std::size_t to,
+                                                                      Reduction<result_type> &histograms) {
+        auto &resultUpdate = histograms.local(tid);
+        const auto &positions = data->positions();
+        const auto &types = data->types();
+        const auto &deactivated = data->deactivated();
+
+        for (auto index = from; index != to; ++index) {
+            if (!deactivated[index] && typesToCount.find(types[index]) != typesToCount.end()) {
+                auto upperBound = std::upper_bound(binBorders.begin(), binBorders.end(), positions[index][axis]);
                 if (upperBound != binBorders.end()) {
                     auto binBordersIdx = upperBound - binBorders.begin();
                     if (binBordersIdx >= 1 && binBordersIdx < resultSize) {
@@ -97,38 +101,29 @@ void CPUHistogramAlongAxis::evaluate() {
                 }
             }
         }
-
-        update.set_value(std::move(resultUpdate));
     };
 
     {
         const std::size_t grainSize = data->size() / kernel->getNThreads();
 
-        std::vector<std::promise<result_type>> promises;
-        promises.resize(kernel->getNThreads());
-
         auto &pool = kernel->pool();
-
-        auto workIter = data->cbegin();
-        for (unsigned int i = 0; i < kernel->getNThreads() - 1; ++i) {
-            updates.push_back(promises.at(i).get_future());
-            pool.push(worker, workIter, workIter + grainSize, std::ref(promises.at(i)));
-            workIter += grainSize;
-        }
-        auto& promise = promises.back();
-        updates.push_back(promise.get_future());
-        pool.push(worker, workIter, data->cend(), std::ref(promise));
-
-
-        for (auto &update : updates) {
-            auto vec = std::move(update.get());
-            auto it1 = vec.begin();
-            auto it2 = result.begin();
-            for (; it1 != vec.end(); ++it1, ++it2) {
-                *it2 += *it1;
+        histograms.reset(pool.size(), result);
+
+        {
+            std::vector<util::thread::joining_future<void>> futures;
+            futures.reserve(kernel->getNThreads());
+            std::size_t workIndex = 0;
+            for (unsigned int i = 0; i < kernel->getNThreads() - 1; ++i) {
+                futures.emplace_back(pool.push(worker, workIndex, workIndex + grainSize, std::ref(histograms)));
+                workIndex += grainSize;
             }
+            futures.emplace_back(pool.push(worker, workIndex, data->size(), std::ref(histograms)));
         }
 
+        result = histograms.reduce([](result_type &lhs, const result_type &rhs) -> result_type & {
+            std::transform(lhs.begin(), lhs.end(), rhs.begin(), lhs.begin(), std::plus<scalar>());
+            return lhs;
+        });
     }
 }
 
@@ -145,9 +140,11 @@ void CPUNParticles::evaluate() {
     } else {
         resultVec.resize(typesToCount.size());
         const auto &pd = kernel->getCPUKernelStateModel().getParticleData();
-        for (const auto &e : *pd) {
-            if (!e.deactivated) {
-                auto typeIt = std::find(typesToCount.begin(), typesToCount.end(), e.type);
+        const auto &types = pd->types();
+        const auto &deactivated = pd->deactivated();
+        for (std::size_t index = 0; index < pd->size(); ++index) {
+            if (!deactivated[index]) {
+                auto typeIt = std::find(typesToCount.begin(), typesToCount.end(), types[index]);
                 if (typeIt != typesToCount.end()) {
                     ++resultVec[typeIt - typesToCount.begin()];
                 }
@@ -167,14 +164,17 @@ void CPUForces::evaluate() {
     if (typesToCount.empty()) {
         result.reserve(pd->size());
     }
-    for (const auto &e : *pd) {
-        if (!e.deactivated) {
+    const auto &forces = pd->forces();
+    const auto &types = pd->types();
+    const auto &deactivated = pd->deactivated();
+    for (std::size_t index = 0; index < pd->size(); ++index) {
+        if (!deactivated[index]) {
             if (typesToCount.empty()) {
-                result.push_back(e.force);
+                result.push_back(forces[index]);
             } else {
                 for (auto countedParticleType : typesToCount) {
-                    if (e.type == countedParticleType) {
-                        result.push_back(e.force);
+                    if (types[index] == countedParticleType) {
+                        result.push_back(forces[index]);
                         break;
                     }
                 }
@@ -198,11 +198,15 @@ void CPUParticles::evaluate() {
     resultTypes.reserve(particleData->size());
     resultIds.reserve(particleData->size());
     resultPositions.reserve(particleData->size());
-    for (const auto &entry : *particleData) {
-        if (!entry.deactivated) {
-            resultTypes.push_back(entry.type);
-            resultIds.push_back(entry.id);
-            resultPositions.push_back(entry.pos);
+    const auto &types = particleData->types();
+    const auto &ids = particleData->ids();
+    const auto &positions = particleData->positions();
+    const auto &deactivated = particleData->deactivated();
+    for (std::size_t index = 0; index < particleData->size(); ++index) {
+        if (!deactivated[index]) {
+            resultTypes.push_back(types[index]);
+            resultIds.push_back(ids[index]);
+            resultPositions.push_back(positions[index]);
         }
     }
 }
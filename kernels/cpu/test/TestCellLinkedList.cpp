@@ -30,6 +30,7 @@
  * @copyright GNU Lesser General Public License v3.0
  */
 
+#include <set>
 #include <gtest/gtest.h>
 #include <readdy/kernel/cpu/nl/ContiguousCellLinkedList.h>
 
@@ -302,6 +303,90 @@ TEST_P(TestCLL, Diffuse) {
     }
 }
 
+template<typename CLL>
+void halfShellTestImpl(std::uint8_t radius) {
+    using namespace readdy;
+
+    model::Context context;
+    context.particle_types().add("Test", 1.);
+    auto id = context.particle_types().idOf("Test");
+    scalar cutoff = 1;
+    context.reactions().addFusion("Fusion", id, id, id, 1., cutoff);
+    context.boxSize()[0] = 10;
+    context.boxSize()[1] = 7;
+    context.boxSize()[2] = 5;
+    context.periodicBoundaryConditions()[0] = true;
+    context.periodicBoundaryConditions()[1] = false;
+    context.periodicBoundaryConditions()[2] = true;
+    context.potentials().addBox(id, .1, {-4.9, -3.4, -2.4}, {9.8, 6.8, 4.8});
+
+    kernel::cpu::thread_pool pool (readdy_default_n_threads());
+
+    kernel::cpu::data::DefaultDataContainer data (context, pool);
+
+    auto n_particles = 1000;
+    for(int i = 0; i < n_particles; ++i) {
+        model::Particle particle(model::rnd::uniform_real<scalar>(-5, 5),
+                                 model::rnd::uniform_real<scalar>(-3.4, 3.4),
+                                 model::rnd::uniform_real<scalar>(-2.5, 2.5), id);
+        data.addParticle(particle);
+    }
+
+    context.configure();
+
+    const auto &d2 = context.distSquaredFun();
+
+    CLL nl(data, context, pool);
+    nl.setUp(0, radius, {});
+    nl.update({});
+
+    // traverse the cells block by block and color by color, every pair must be visited exactly once
+    std::set<std::tuple<std::size_t, std::size_t>> pairs;
+    std::vector<std::size_t> cellVisits(nl.nCells(), 0);
+    for (std::uint8_t color = 0; color < kernel::cpu::nl::CellLinkedList::nColors; ++color) {
+        for (const auto &block : nl.blocksOfColor(color)) {
+            for (auto i = block.begin[0]; i < block.end[0]; ++i) {
+                for (auto j = block.begin[1]; j < block.end[1]; ++j) {
+                    for (auto k = block.begin[2]; k < block.end[2]; ++k) {
+                        auto cell = nl.cellIndex()(i, j, k);
+                        ++cellVisits.at(cell);
+                        for (auto it = nl.particlesBegin(cell); it != nl.particlesEnd(cell); ++it) {
+                            auto pidx = *it;
+                            nl.forEachHalfNeighbor(it, cell, [&](auto neighbor) {
+                                ASSERT_NE(pidx, neighbor);
+                                auto inserted = pairs.emplace(std::min(pidx, neighbor), std::max(pidx, neighbor));
+                                ASSERT_TRUE(inserted.second) << "pair (" << pidx << ", " << neighbor
+                                                             << ") was visited twice";
+                            });
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    for (auto visits : cellVisits) {
+        ASSERT_EQ(visits, 1);
+    }
+
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        for (std::size_t j = i + 1; j < data.size(); ++j) {
+            if (d2(data.entry_at(i).pos, data.entry_at(j).pos) < cutoff * cutoff) {
+                ASSERT_NE(pairs.find(std::make_tuple(i, j)), pairs.end()) << "pair (" << i << ", " << j
+                                                                          << ") was not visited";
+            }
+        }
+    }
+}
+
+TEST_P(TestCLL, HalfShell) {
+    if (cllName() == "CompactCLL") {
+        halfShellTestImpl<readdy::kernel::cpu::nl::CompactCellLinkedList>(cllRadius());
+    } else if(cllName() == "ContiguousCLL") {
+        halfShellTestImpl<readdy::kernel::cpu::nl::ContiguousCellLinkedList>(cllRadius());
+    }
+}
+
 }
 
 INSTANTIATE_TEST_CASE_P(TestCellLinkedList, TestCLL,
@@ -29,10 +29,14 @@
  * @date 23.06.16
  */
 
+#include <algorithm>
+#include <set>
 #include <gtest/gtest.h>
 #include <readdy/plugin/KernelProvider.h>
 #include <readdy/model/actions/Actions.h>
 #include <readdy/model/RandomProvider.h>
+#include <readdy/kernel/cpu/Reduction.h>
+#include <readdy/kernel/cpu/CPUKernel.h>
 
 namespace {
 
@@ -76,4 +80,272 @@ TEST(CPUTestKernel, TestKernelLoad) {
 
     connection.disconnect();
 }
+
+TEST(CPUTestKernel, AutoTuneNeighborList) {
+    using namespace readdy;
+    kernel::cpu::CPUKernel kernel;
+    auto &context = kernel.context();
+    context.boxSize() = {{10, 10, 10}};
+    context.periodicBoundaryConditions() = {{true, true, true}};
+    context.particle_types().add("A", 1.);
+    context.potentials().addHarmonicRepulsion("A", "A", 1., 1.);
+    auto &configuration = context.kernelConfiguration().cpu.neighborList;
+    configuration.auto_tune = true;
+    configuration.auto_tune_steps = 2;
+
+    for (auto i = 0; i < 500; ++i) {
+        kernel.stateModel().addParticle({model::rnd::uniform_real<scalar>(-5, 5),
+                                         model::rnd::uniform_real<scalar>(-5, 5),
+                                         model::rnd::uniform_real<scalar>(-5, 5), 0});
+    }
+    const auto particlesBefore = kernel.stateModel().getParticles();
+
+    util::PerformanceNode node{"tune", true};
+    kernel.tune(.01, node);
+
+    // the choice is stored in the configuration and the particles are where they were
+    EXPECT_FALSE(configuration.auto_tune);
+    EXPECT_GE(configuration.cll_radius, 1);
+    EXPECT_LE(configuration.cll_radius, 3);
+    EXPECT_TRUE(configuration.skin == 0 || configuration.verlet);
+    const auto particlesAfter = kernel.stateModel().getParticles();
+    ASSERT_EQ(particlesBefore.size(), particlesAfter.size());
+    std::unordered_map<model::Particle::id_type, Vec3> positions;
+    for (const auto &particle : particlesBefore) {
+        positions[particle.getId()] = particle.getPos();
+    }
+    for (const auto &particle : particlesAfter) {
+        EXPECT_EQ(positions.at(particle.getId()), particle.getPos());
+    }
+    EXPECT_GT(node.n_children(), 1);
+
+    // tuning again does nothing
+    kernel.tune(.01, node);
+    EXPECT_FALSE(configuration.auto_tune);
+}
+
+TEST(CPUTestKernel, IdIndex) {
+    using namespace readdy;
+    kernel::cpu::CPUKernel kernel;
+    kernel.context().boxSize() = {{10, 10, 10}};
+    kernel.context().particle_types().add("A", 1.);
+    auto &data = *kernel.getCPUKernelStateModel().getParticleData();
+
+    std::vector<model::Particle> particles;
+    for (auto i = 0; i < 100; ++i) {
+        particles.emplace_back(model::rnd::uniform_real<scalar>(-5, 5), model::rnd::uniform_real<scalar>(-5, 5),
+                               model::rnd::uniform_real<scalar>(-5, 5), 0);
+    }
+    data.addParticles(particles);
+    data.indexIds(true);
+
+    auto check = [&]() {
+        std::vector<model::Particle::id_type> ids;
+        std::vector<std::size_t> indices;
+        for (std::size_t index = 0; index < data.size(); ++index) {
+            const auto &entry = data.entry_at(index);
+            if (!entry.deactivated) {
+                ASSERT_EQ(data.getIndexForId(entry.id), index);
+                ids.push_back(entry.id);
+                indices.push_back(index);
+            }
+        }
+        EXPECT_EQ(data.getIndicesForIds(ids), indices);
+        // the indexed lookup agrees with the scan
+        data.indexIds(false);
+        EXPECT_EQ(data.getIndicesForIds(ids), indices);
+        data.indexIds(true);
+    };
+    check();
+
+    data.removeParticle(particles.at(5));
+    data.removeParticle(data.getIndexForId(particles.at(17).getId()));
+    EXPECT_THROW(data.getIndexForId(particles.at(5).getId()), std::out_of_range);
+    EXPECT_THROW(data.getIndexForId(particles.at(17).getId()), std::out_of_range);
+    check();
+
+    // the blanks are reused, a replaced entry loses its id
+    std::vector<kernel::cpu::data::Entry> newEntries;
+    newEntries.emplace_back(model::Particle(0, 0, 0, 0));
+    newEntries.emplace_back(model::Particle(1, 1, 1, 0));
+    newEntries.emplace_back(model::Particle(2, 2, 2, 0));
+    const auto replacedId = data.entry_at(42).id;
+    data.update(std::make_tuple(std::move(newEntries), std::vector<std::size_t>{42}));
+    EXPECT_THROW(data.getIndexForId(replacedId), std::out_of_range);
+    check();
+
+    data.setId(0, model::Particle::nextId());
+    EXPECT_THROW(data.getIndexForId(particles.at(0).getId()), std::out_of_range);
+    EXPECT_EQ(data.getIndexForId(data.entry_at(0).id), 0);
+    check();
+
+    data.hilbertSort(1.);
+    check();
+
+    // lookups through the state model do not enable the index, the configuration does
+    data.indexIds(false);
+    const auto id = kernel.stateModel().getParticles().front().getId();
+    EXPECT_EQ(kernel.stateModel().getParticlesForIds({id}).front().getId(), id);
+    EXPECT_FALSE(data.idsIndexed());
+    kernel.context().kernelConfiguration().cpu.particleData.index_ids = true;
+    kernel.initialize();
+    EXPECT_TRUE(data.idsIndexed());
+    check();
+}
+
+TEST(CPUTestKernel, BulkAddParticles) {
+    using namespace readdy;
+    kernel::cpu::CPUKernel kernel;
+    kernel.context().boxSize() = {{10, 10, 10}};
+    kernel.context().particle_types().add("A", 1.);
+    kernel.context().particle_types().add("B", 1.);
+    auto &data = *kernel.getCPUKernelStateModel().getParticleData();
+    data.indexIds(true);
+
+    data.addParticles({model::Particle(0, 0, 0, 1), model::Particle(1, 0, 0, 1), model::Particle(2, 0, 0, 1)});
+    data.removeParticle(1);
+
+    std::vector<Vec3> positions;
+    for (auto i = 0; i < 1000; ++i) {
+        positions.emplace_back(model::rnd::uniform_real<scalar>(-5, 5), model::rnd::uniform_real<scalar>(-5, 5),
+                               model::rnd::uniform_real<scalar>(-5, 5));
+    }
+    kernel.stateModel().addParticles(0, positions);
+
+    // the blank is reused, the remaining particles are appended
+    ASSERT_EQ(data.size(), 1002);
+    ASSERT_EQ(data.getNDeactivated(), 0);
+    const auto firstId = data.entry_at(1).id;
+    EXPECT_EQ(data.entry_at(1).pos, positions.front());
+    for (std::size_t i = 1; i < positions.size(); ++i) {
+        const auto &entry = data.entry_at(2 + i);
+        EXPECT_EQ(entry.type, 0);
+        EXPECT_EQ(entry.pos, positions.at(i));
+        EXPECT_EQ(entry.id, firstId + i) << "the ids should form one contiguous block";
+        EXPECT_FALSE(entry.deactivated);
+        EXPECT_EQ(entry.topology_index, -1);
+        EXPECT_EQ(data.getIndexForId(entry.id), 2 + i);
+    }
+    EXPECT_EQ(data.entry_at(0).type, 1);
+    EXPECT_EQ(data.entry_at(2).type, 1);
+}
+
+TEST(CPUTestKernel, FieldArrays) {
+    using namespace readdy;
+    kernel::cpu::CPUKernel kernel;
+    kernel.context().boxSize() = {{10, 10, 10}};
+    kernel.context().particle_types().add("A", 1.);
+    kernel.context().particle_types().add("B", 1.);
+    auto &data = *kernel.getCPUKernelStateModel().getParticleData();
+
+    std::vector<model::Particle> particles;
+    for (auto i = 0; i < 100; ++i) {
+        particles.emplace_back(model::rnd::uniform_real<scalar>(-5, 5), model::rnd::uniform_real<scalar>(-5, 5),
+                               model::rnd::uniform_real<scalar>(-5, 5), i % 2);
+    }
+    data.addParticles(particles);
+
+    // writes through the entry references end up in the field arrays
+    auto entry = data.entry_at(3);
+    entry.force = {1, 2, 3};
+    entry.pos += Vec3(.5, 0, 0);
+    EXPECT_EQ(data.forces().at(3), Vec3(1, 2, 3));
+    EXPECT_EQ(data.positions().at(3), particles.at(3).getPos() + Vec3(.5, 0, 0));
+
+    for (auto i = 0; i < 100; i += 3) {
+        data.removeParticle(particles.at(i));
+    }
+    data.compact();
+    data.hilbertSort(1.);
+
+    auto check = [&data](const std::vector<model::Particle::id_type> &ids) {
+        ASSERT_EQ(data.size(), ids.size());
+        ASSERT_EQ(data.forces().size(), data.size());
+        ASSERT_EQ(data.types().size(), data.size());
+        ASSERT_EQ(data.ids().size(), data.size());
+        ASSERT_EQ(data.deactivated().size(), data.size());
+        ASSERT_EQ(data.topologyIndices().size(), data.size());
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(data.positions().data()) % 64, 0);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(data.forces().data()) % 64, 0);
+        std::vector<model::Particle::id_type> seen;
+        std::size_t index = 0;
+        for (const auto &e : data) {
+            EXPECT_FALSE(e.deactivated);
+            EXPECT_EQ(e.id, data.ids()[index]);
+            EXPECT_EQ(e.type, data.types()[index]);
+            EXPECT_EQ(e.pos, data.positions()[index]);
+            seen.push_back(e.id);
+            ++index;
+        }
+        std::sort(seen.begin(), seen.end());
+        EXPECT_EQ(seen, ids);
+    };
+
+    std::vector<model::Particle::id_type> ids;
+    for (auto i = 0; i < 100; ++i) {
+        if (i % 3 != 0) ids.push_back(particles.at(i).getId());
+    }
+    std::sort(ids.begin(), ids.end());
+    check(ids);
+
+    const auto &moved = data.entry_at(data.getIndexForId(particles.at(4).getId()));
+    EXPECT_EQ(moved.type, particles.at(4).getType());
+    EXPECT_EQ(data.getParticle(data.getIndexForId(particles.at(4).getId())).getPos(), particles.at(4).getPos());
+}
+
+TEST(CPUTestKernel, IdBlock) {
+    using namespace readdy;
+    kernel::cpu::data::IdBlock block(4);
+    std::vector<model::Particle::id_type> ids;
+    for (auto i = 0; i < 10; ++i) {
+        ids.push_back(block.next());
+        // ids taken from the global counter in between do not interfere with the block
+        model::Particle::nextId();
+    }
+    std::set<model::Particle::id_type> unique(ids.begin(), ids.end());
+    EXPECT_EQ(unique.size(), ids.size());
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        if (i % 4 != 0) {
+            EXPECT_EQ(ids.at(i), ids.at(i - 1) + 1) << "ids within a block should be consecutive";
+        }
+    }
+
+    // a block size of one takes each id directly from the global counter
+    block.reset(1);
+    const auto id = block.next();
+    EXPECT_EQ(model::Particle::nextId(), id + 1);
+    EXPECT_EQ(block.next(), id + 2);
+
+    kernel::cpu::CPUKernel kernel;
+    kernel.context().kernelConfiguration().cpu.particleData.id_block_size = 8;
+    kernel.initialize();
+    EXPECT_EQ(kernel.getCPUKernelStateModel().getParticleData()->idBlock().blockSize(), 8);
+}
+
+TEST(CPUTestKernel, Reduction) {
+    using namespace readdy;
+    kernel::cpu::Reduction<scalar> reduction;
+    for (std::size_t nThreads = 1; nThreads < 9; ++nThreads) {
+        reduction.reset(nThreads, 0);
+        const auto *slot = &reduction.local(0);
+        for (int step = 0; step < 2; ++step) {
+            reduction.reset(nThreads, 0);
+            EXPECT_EQ(slot, &reduction.local(0)) << "resetting with the same number of threads should not reallocate";
+            for (std::size_t tid = 0; tid < nThreads; ++tid) {
+                reduction.local(tid) += tid + 1;
+                reduction.local(tid) += 1;
+            }
+            EXPECT_EQ(reduction.reduce(), nThreads * (nThreads + 1) / 2 + nThreads);
+        }
+    }
+    kernel::cpu::Reduction<std::vector<int>> histograms(3, {0, 0});
+    histograms.local(0) = {1, 2};
+    histograms.local(2) = {3, 4};
+    auto result = histograms.reduce([](std::vector<int> &lhs, const std::vector<int> &rhs) -> std::vector<int> & {
+        lhs[0] += rhs[0];
+        lhs[1] += rhs[1];
+        return lhs;
+    });
+    EXPECT_EQ(result, (std::vector<int>{4, 6}));
+}
 }
\ No newline at end of file
@@ -97,6 +97,77 @@ auto isIdPairInList = [](nl_t *pairs, readdy::kernel::cpu::data::DefaultDataCont
     return isPairInList(pairs, data.getIndexForId(id1), data.getIndexForId(id2));
 };
 
+using IndexPair = std::tuple<std::size_t, std::size_t>;
+using PairSet = std::unordered_set<IndexPair, readdy::util::ForwardTupleHasher<IndexPair>,
+        readdy::util::ForwardTupleEquality<IndexPair>>;
+
+/**
+ * Collects all pairs (i, j), i < j, of active particles which are closer than cutoffFn(i, j).
+ */
+template<typename Distance, typename Cutoff>
+PairSet bruteForcePairs(const cpu::data::DefaultDataContainer &data, const Distance &d2, const Cutoff &cutoffFn) {
+    PairSet pairs;
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        if (data.entry_at(i).deactivated) continue;
+        for (std::size_t j = i + 1; j < data.size(); ++j) {
+            const auto cutoff = cutoffFn(i, j);
+            if (!data.entry_at(j).deactivated && d2(data.entry_at(i).pos, data.entry_at(j).pos) < cutoff * cutoff) {
+                pairs.insert(std::make_tuple(i, j));
+            }
+        }
+    }
+    return pairs;
+}
+
+/**
+ * Removes a pair that was visited by the neighbor list, it has to be known and not visited before.
+ */
+void visitPair(PairSet &pairs, std::size_t i, std::size_t j) {
+    auto findIt = pairs.find(std::make_tuple(std::min(i, j), std::max(i, j)));
+    ASSERT_NE(findIt, pairs.end()) << "A pair was visited more than once or is unknown";
+    pairs.erase(findIt);
+}
+
+/**
+ * Checks that the half shells of all cells yield each pair within cutoffFn(i, j) exactly once.
+ */
+template<typename Distance, typename Cutoff>
+void expectHalfShellMatchesBruteForce(const nl_t &neighborList, const cpu::data::DefaultDataContainer &data,
+                                      const Distance &d2, const Cutoff &cutoffFn) {
+    auto pairs = bruteForcePairs(data, d2, cutoffFn);
+    for (std::size_t cell = 0; cell < neighborList.nCells(); ++cell) {
+        for (auto it = neighborList.particlesBegin(cell); it != neighborList.particlesEnd(cell); ++it) {
+            const auto particle = *it;
+            neighborList.forEachHalfNeighbor(it, cell, [&](std::size_t neighbor) {
+                const auto cutoff = cutoffFn(particle, neighbor);
+                if (d2(data.entry_at(particle).pos, data.entry_at(neighbor).pos) < cutoff * cutoff) {
+                    visitPair(pairs, particle, neighbor);
+                }
+            });
+        }
+    }
+    EXPECT_EQ(pairs.size(), 0) << "Some pairs were not contained in the NL";
+}
+
+/**
+ * Checks that the full neighbors of the active particles yield each pair within cutoffFn(i, j) exactly twice.
+ */
+template<typename Distance, typename Cutoff>
+void expectFullShellMatchesBruteForce(const nl_t &neighborList, const cpu::data::DefaultDataContainer &data,
+                                      const Distance &d2, const Cutoff &cutoffFn) {
+    auto pairs = bruteForcePairs(data, d2, cutoffFn);
+    for (std::size_t index = 0; index < data.size(); ++index) {
+        if (data.entry_at(index).deactivated) continue;
+        neighborList.forEachNeighbor(index, [&](std::size_t neighbor) {
+            const auto cutoff = cutoffFn(index, neighbor);
+            if (index < neighbor && d2(data.entry_at(index).pos, data.entry_at(neighbor).pos) < cutoff * cutoff) {
+                visitPair(pairs, index, neighbor);
+            }
+        });
+    }
+    EXPECT_EQ(pairs.size(), 0) << "Some pairs were not contained in the NL";
+}
+
 TEST_F(TestNeighborList, ThreeBoxesNonPeriodic) {
     // maxcutoff is 1.2, system is 1.5 x 4 x 1.5, non-periodic, three cells
     auto &ctx = kernel->context();
@@ -279,6 +350,670 @@ TEST(TestNeighborListImpl, Diffusion) {
     }
 }
 
+TEST(TestNeighborListImpl, VerletHalfNeighbors) {
+    using namespace readdy;
+
+    kernel::cpu::CPUKernel kernel;
+    auto &context = kernel.context();
+    context.particle_types().add("A", 1.);
+    scalar cutoff = 1.5;
+    // just to have a cutoff
+    context.reactions().addFusion("test", "A", "A", "A", 0., cutoff);
+    context.periodicBoundaryConditions() = {{true, true, true}};
+    context.boxSize() = {{10, 8, 6}};
+
+    for (auto i = 0; i < 500; ++i) {
+        kernel.stateModel().addParticle({model::rnd::uniform_real<scalar>(-5, 5),
+                                         model::rnd::uniform_real<scalar>(-4, 4),
+                                         model::rnd::uniform_real<scalar>(-3, 3), 0});
+    }
+    kernel.initialize();
+
+    auto &neighborList = *kernel.getCPUKernelStateModel().getNeighborList();
+    neighborList.verlet() = true;
+    kernel.stateModel().initializeNeighborList(.4);
+
+    auto integrator = kernel.actions().eulerBDIntegrator(.001);
+    const auto &d2 = context.distSquaredFun();
+    const auto &data = *kernel.getCPUKernelStateModel().getParticleData();
+
+    for (auto t = 0U; t < 20; ++t) {
+        integrator->perform();
+        kernel.stateModel().updateNeighborList();
+        ASSERT_TRUE(neighborList.verletValid());
+        // the cached lists yield each pair within the cutoff exactly once
+        expectHalfShellMatchesBruteForce(neighborList, data, d2, [=](std::size_t, std::size_t) { return cutoff; });
+    }
+}
+
+TEST(TestNeighborListImpl, IncrementalEdits) {
+    using namespace readdy;
+
+    kernel::cpu::CPUKernel kernel;
+    auto &context = kernel.context();
+    context.particle_types().add("A", 1.);
+    context.reactions().addFusion("test", "A", "A", "A", 0., 1.5);
+    context.periodicBoundaryConditions() = {{true, true, true}};
+    context.boxSize() = {{10, 8, 6}};
+
+    auto randomPosition = [] {
+        return Vec3(model::rnd::uniform_real<scalar>(-5, 5), model::rnd::uniform_real<scalar>(-4, 4),
+                    model::rnd::uniform_real<scalar>(-3, 3));
+    };
+    for (auto i = 0; i < 300; ++i) {
+        kernel.stateModel().addParticle({randomPosition(), 0});
+    }
+    kernel.initialize();
+
+    auto &neighborList = *kernel.getCPUKernelStateModel().getNeighborList();
+    auto &data = *kernel.getCPUKernelStateModel().getParticleData();
+    kernel.stateModel().initializeNeighborList(.4);
+    ASSERT_TRUE(data.editsComplete());
+
+    for (auto t = 0U; t < 10; ++t) {
+        // mimic a round of reactions: some particles are replaced, some removed, some added and one is displaced
+        std::vector<cpu::data::Entry> newEntries;
+        std::vector<std::size_t> removedEntries;
+        for (std::size_t i = t; i < data.size(); i += 13) {
+            if (!data.entry_at(i).deactivated) {
+                removedEntries.push_back(i);
+            }
+        }
+        for (auto i = 0; i < 30; ++i) {
+            newEntries.emplace_back(model::Particle(randomPosition(), 0));
+        }
+        data.update(std::make_tuple(std::move(newEntries), std::move(removedEntries)));
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            if (!data.entry_at(i).deactivated) {
+                data.displace(i, {1.5, 0, 0});
+                break;
+            }
+        }
+        ASSERT_TRUE(data.editsComplete());
+        ASSERT_FALSE(data.edits().empty());
+        kernel.stateModel().updateNeighborList();
+        EXPECT_TRUE(data.edits().empty());
+
+        // each active particle is contained exactly once and in the correct cell
+        std::vector<std::size_t> seen(data.size(), 0);
+        for (auto cell = 0_z; cell < neighborList.nCells(); ++cell) {
+            for (auto it = neighborList.particlesBegin(cell); it != neighborList.particlesEnd(cell); ++it) {
+                ASSERT_FALSE(data.entry_at(*it).deactivated);
+                EXPECT_EQ(neighborList.cellOfParticle(*it), cell);
+                ++seen.at(*it);
+            }
+        }
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            EXPECT_EQ(seen[i], data.entry_at(i).deactivated ? 0 : 1);
+        }
+    }
+}
+
+TEST(TestNeighborListImpl, HilbertSort) {
+    using namespace readdy;
+
+    kernel::cpu::CPUKernel kernel;
+    auto &context = kernel.context();
+    context.particle_types().add("A", 1.);
+    context.reactions().addFusion("test", "A", "A", "A", 0., 1.);
+    context.periodicBoundaryConditions() = {{true, true, true}};
+    context.boxSize() = {{10, 8, 6}};
+
+    for (auto i = 0; i < 1000; ++i) {
+        kernel.stateModel().addParticle({model::rnd::uniform_real<scalar>(-5, 5),
+                                         model::rnd::uniform_real<scalar>(-4, 4),
+                                         model::rnd::uniform_real<scalar>(-3, 3), 0});
+    }
+    kernel.stateModel().removeParticle(kernel.stateModel().getParticles().at(10));
+    kernel.initialize();
+
+    auto &neighborList = *kernel.getCPUKernelStateModel().getNeighborList();
+    auto &data = *kernel.getCPUKernelStateModel().getParticleData();
+    neighborList.hilbertSortInterval() = 2;
+
+    std::vector<model::Particle::id_type> ids;
+    std::vector<std::size_t> permutation;
+    auto connection = data.registerReorderEventListener([&](const std::vector<std::size_t> &p) {
+        permutation = p;
+        ids.clear();
+        for (const auto &entry : data) {
+            ids.push_back(entry.deactivated ? 0 : entry.id);
+        }
+    });
+
+    kernel.stateModel().initializeNeighborList(0);
+    EXPECT_TRUE(permutation.empty());
+    // as if all particles had moved, so that the bins are rebuilt
+    data.invalidateEdits();
+    kernel.stateModel().updateNeighborList();
+    ASSERT_EQ(permutation.size(), data.size());
+
+    // the permutation maps old onto new indices
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        if (ids[i] != 0) {
+            EXPECT_EQ(data.entry_at(permutation[i]).id, ids[i]);
+        }
+    }
+    EXPECT_TRUE(data.entry_at(0).deactivated);
+    EXPECT_FALSE(data.entry_at(1).deactivated);
+
+    // after reordering, the particles of a cell are mostly contiguous in memory
+    std::size_t nJumps = 0;
+    auto previous = neighborList.nCells();
+    for (std::size_t i = 1; i < data.size(); ++i) {
+        const auto cell = neighborList.cellOfParticle(i);
+        if (cell != previous) ++nJumps;
+        previous = cell;
+    }
+    EXPECT_LT(nJumps, 2 * neighborList.nCells());
+
+    // and the bins refer to the new order
+    std::size_t nBinned = 0;
+    for (auto cell = 0_z; cell < neighborList.nCells(); ++cell) {
+        for (auto it = neighborList.particlesBegin(cell); it != neighborList.particlesEnd(cell); ++it) {
+            EXPECT_EQ(neighborList.cellOfParticle(*it), cell);
+            ++nBinned;
+        }
+    }
+    EXPECT_EQ(nBinned, data.size() - 1);
+}
+
+TEST(TestNeighborListImpl, DeterministicParallelBins) {
+    using namespace readdy;
+
+    kernel::cpu::CPUKernel kernel;
+    auto &context = kernel.context();
+    context.particle_types().add("A", 1.);
+    context.reactions().addFusion("test", "A", "A", "A", 0., 1.);
+    context.periodicBoundaryConditions() = {{true, true, true}};
+    context.boxSize() = {{10, 8, 6}};
+
+    for (auto i = 0; i < 2000; ++i) {
+        kernel.stateModel().addParticle({model::rnd::uniform_real<scalar>(-5, 5),
+                                         model::rnd::uniform_real<scalar>(-4, 4),
+                                         model::rnd::uniform_real<scalar>(-3, 3), 0});
+    }
+    kernel.stateModel().removeParticle(kernel.stateModel().getParticles().at(42));
+    kernel.initialize();
+
+    auto &neighborList = *kernel.getCPUKernelStateModel().getNeighborList();
+    auto &data = *kernel.getCPUKernelStateModel().getParticleData();
+    kernel.stateModel().initializeNeighborList(0);
+    ASSERT_TRUE(neighborList.contiguous());
+
+    std::size_t nBinned = 0;
+    for (auto cell = 0_z; cell < neighborList.nCells(); ++cell) {
+        // the linked list of a cell follows its contents, which are in ascending order
+        auto k = neighborList.cellBegin(cell);
+        for (auto it = neighborList.particlesBegin(cell); it != neighborList.particlesEnd(cell); ++it, ++k) {
+            ASSERT_LT(k, neighborList.cellEnd(cell));
+            EXPECT_EQ(*it, neighborList.cellContents().at(k));
+            if (k > neighborList.cellBegin(cell)) {
+                EXPECT_LT(neighborList.cellContents().at(k - 1), *it);
+            }
+            EXPECT_EQ(neighborList.cellOfParticle(*it), cell);
+            ++nBinned;
+        }
+        EXPECT_EQ(k, neighborList.cellEnd(cell));
+    }
+    EXPECT_EQ(nBinned, data.size() - 1);
+
+    // rebuilding yields the same lists
+    const auto head = neighborList.head();
+    const auto list = neighborList.list();
+    data.invalidateEdits();
+    kernel.stateModel().updateNeighborList();
+    ASSERT_EQ(head.size(), neighborList.head().size());
+    for (auto cell = 0_z; cell < head.size(); ++cell) {
+        EXPECT_EQ((*head[cell]).load(), (*neighborList.head()[cell]).load());
+    }
+    EXPECT_EQ(list, neighborList.list());
+}
+
+TEST(TestNeighborListImpl, SortByCell) {
+    using namespace readdy;
+
+    kernel::cpu::CPUKernel kernel;
+    auto &context = kernel.context();
+    context.particle_types().add("A", 1.);
+    scalar cutoff = 1.5;
+    context.reactions().addFusion("test", "A", "A", "A", 0., cutoff);
+    context.periodicBoundaryConditions() = {{true, true, true}};
+    context.boxSize() = {{10, 8, 6}};
+
+    for (auto i = 0; i < 500; ++i) {
+        kernel.stateModel().addParticle({model::rnd::uniform_real<scalar>(-5, 5),
+                                         model::rnd::uniform_real<scalar>(-4, 4),
+                                         model::rnd::uniform_real<scalar>(-3, 3), 0});
+    }
+    kernel.stateModel().removeParticle(kernel.stateModel().getParticles().at(0));
+    kernel.initialize();
+
+    auto &neighborList = *kernel.getCPUKernelStateModel().getNeighborList();
+    neighborList.sortByCell() = true;
+    kernel.stateModel().initializeNeighborList(0);
+    ASSERT_TRUE(neighborList.contiguous());
+
+    const auto &d2 = context.distSquaredFun();
+    const auto &data = *kernel.getCPUKernelStateModel().getParticleData();
+    EXPECT_TRUE(data.entry_at(data.size() - 1).deactivated);
+
+    // each cell is a contiguous range of ascending indices
+    for (auto cell = 0_z; cell < neighborList.nCells(); ++cell) {
+        auto index = neighborList.cellBegin(cell);
+        for (auto it = neighborList.particlesBegin(cell); it != neighborList.particlesEnd(cell); ++it, ++index) {
+            EXPECT_EQ(*it, index);
+            EXPECT_EQ(neighborList.cellOfParticle(*it), cell);
+        }
+        EXPECT_EQ(index, neighborList.cellEnd(cell));
+    }
+
+    expectHalfShellMatchesBruteForce(neighborList, data, d2, [=](std::size_t, std::size_t) { return cutoff; });
+}
+
+TEST(TestNeighborListImpl, ImageShifts) {
+    using namespace readdy;
+
+    kernel::cpu::CPUKernel kernel;
+    auto &context = kernel.context();
+    context.particle_types().add("A", 1.);
+    scalar cutoff = 1.5;
+    context.reactions().addFusion("test", "A", "A", "A", 0., cutoff);
+    context.periodicBoundaryConditions() = {{true, true, false}};
+    context.boxSize() = {{10, 8, 6}};
+    context.potentials().addBox("A", 0., {-4.9, -3.9, -2.9}, {9.8, 7.8, 5.8});
+
+    for (auto i = 0; i < 500; ++i) {
+        kernel.stateModel().addParticle({model::rnd::uniform_real<scalar>(-5, 5),
+                                         model::rnd::uniform_real<scalar>(-4, 4),
+                                         model::rnd::uniform_real<scalar>(-3, 3), 0});
+    }
+    kernel.initialize();
+
+    auto &neighborList = *kernel.getCPUKernelStateModel().getNeighborList();
+    kernel.stateModel().initializeNeighborList(0);
+    ASSERT_TRUE(neighborList.imageShiftsAvailable());
+
+    const auto &d2 = context.distSquaredFun();
+    const auto &shortestDifference = context.shortestDifferenceFun();
+    const auto &data = *kernel.getCPUKernelStateModel().getParticleData();
+
+    auto pairs = bruteForcePairs(data, d2, [=](std::size_t, std::size_t) { return cutoff; });
+    for (auto cell = 0_z; cell < neighborList.nCells(); ++cell) {
+        for (auto it = neighborList.particlesBegin(cell); it != neighborList.particlesEnd(cell); ++it) {
+            const auto particle = *it;
+            neighborList.forEachHalfNeighborShifted(it, cell, [&](std::size_t neighbor, const Vec3 &shift) {
+                // within the cutoff the plain difference to the shifted image is the minimum image difference
+                const auto &pos = data.entry_at(particle).pos;
+                const auto difference = data.entry_at(neighbor).pos + shift - pos;
+                if (difference * difference < cutoff * cutoff) {
+                    const auto expected = shortestDifference(pos, data.entry_at(neighbor).pos);
+                    for (int d = 0; d < 3; ++d) {
+                        EXPECT_NEAR(difference[d], expected[d], 1e-4);
+                    }
+                    visitPair(pairs, particle, neighbor);
+                }
+            });
+        }
+    }
+    EXPECT_EQ(pairs.size(), 0) << "Some pairs were not contained in the NL";
+
+    // with too few cells along a periodic axis an adjacent cell is reached through several images
+    kernel::cpu::CPUKernel narrowKernel;
+    narrowKernel.context().particle_types().add("A", 1.);
+    narrowKernel.context().reactions().addFusion("test", "A", "A", "A", 0., cutoff);
+    narrowKernel.context().periodicBoundaryConditions() = {{true, true, true}};
+    narrowKernel.context().boxSize() = {{10, 8, 3}};
+    narrowKernel.stateModel().addParticle({0, 0, 0, 0});
+    narrowKernel.initialize();
+    narrowKernel.stateModel().initializeNeighborList(0);
+    EXPECT_FALSE(narrowKernel.getCPUKernelStateModel().getNeighborList()->imageShiftsAvailable());
+}
+
+TEST(TestNeighborListImpl, PairList) {
+    using namespace readdy;
+    using IndexPair = std::tuple<std::size_t, std::size_t>;
+
+    kernel::cpu::CPUKernel kernel;
+    auto &context = kernel.context();
+    context.particle_types().add("A", 1.);
+    context.particle_types().add("B", 1.);
+    context.particle_types().add("C", 1.);
+    context.potentials().addHarmonicRepulsion("A", "A", 1., 1.);
+    context.reactions().addFusion("test", "A", "B", "A", 1., 1.5);
+    context.periodicBoundaryConditions() = {{true, true, false}};
+    context.boxSize() = {{10, 8, 6}};
+    for (const auto &type : {"A", "B", "C"}) {
+        context.potentials().addBox(type, 0., {-4.9, -3.9, -2.9}, {9.8, 7.8, 5.8});
+    }
+
+    for (auto i = 0; i < 600; ++i) {
+        kernel.stateModel().addParticle({model::rnd::uniform_real<scalar>(-5, 5),
+                                         model::rnd::uniform_real<scalar>(-4, 4),
+                                         model::rnd::uniform_real<scalar>(-3, 3),
+                                         static_cast<particle_type_type>(i % 3)});
+    }
+    kernel.initialize();
+    kernel.stateModel().initializeNeighborList(0);
+
+    auto &stateModel = kernel.getCPUKernelStateModel();
+    const auto &data = *stateModel.getParticleData();
+    const auto &d2 = context.distSquaredFun();
+    const auto cutoff = stateModel.getNeighborList()->maxCutoff();
+
+    auto &&forces = kernel.actions().calculateForces();
+    forces->perform();
+    std::vector<Vec3> expectedForces;
+    for (const auto &entry : data) {
+        expectedForces.push_back(entry.force);
+    }
+    const auto expectedEnergy = stateModel.energy();
+
+    auto &pairList = stateModel.pairList();
+    pairList.enabled() = true;
+    stateModel.updatePairList({});
+    ASSERT_TRUE(pairList.upToDate());
+
+    // pairs of particles with interacting types within the cutoff, C does not interact with anything
+    std::unordered_set<IndexPair, util::ForwardTupleHasher<IndexPair>, util::ForwardTupleEquality<IndexPair>> pairs;
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        for (std::size_t j = i + 1; j < data.size(); ++j) {
+            const auto t1 = data.entry_at(i).type;
+            const auto t2 = data.entry_at(j).type;
+            if (t1 != 2 && t2 != 2 && !(t1 == 1 && t2 == 1)
+                && d2(data.entry_at(i).pos, data.entry_at(j).pos) < cutoff * cutoff) {
+                pairs.insert(std::make_tuple(i, j));
+            }
+        }
+    }
+    EXPECT_EQ(pairList.size(), pairs.size());
+    pairList.forEachPair([&](const kernel::cpu::nl::PairList::Pair &pair) {
+        EXPECT_NEAR(pair.distSquared, d2(data.entry_at(pair.i).pos, data.entry_at(pair.j).pos), 1e-4);
+        EXPECT_EQ(pairs.erase(std::make_tuple(std::min(pair.i, pair.j), std::max(pair.i, pair.j))), 1);
+    });
+    EXPECT_EQ(pairs.size(), 0) << "Some pairs were not contained in the pair list";
+
+    // the forces from the pair list are the same
+    forces->perform();
+    EXPECT_NEAR(stateModel.energy(), expectedEnergy, 1e-3);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        for (int d = 0; d < 3; ++d) {
+            EXPECT_NEAR(data.entry_at(i).force[d], expectedForces[i][d], 1e-4);
+        }
+    }
+
+    // an update of the neighbor list without changes of the particle data keeps the pairs, a rebuild does not
+    kernel.stateModel().updateNeighborList();
+    EXPECT_TRUE(pairList.upToDate());
+    stateModel.getParticleData()->invalidateEdits();
+    kernel.stateModel().updateNeighborList();
+    EXPECT_FALSE(pairList.upToDate());
+
+    // converting C into A after the pair list was built, the converted particles start to interact
+    stateModel.updatePairList({});
+    ASSERT_TRUE(pairList.upToDate());
+    auto &mutableData = *stateModel.getParticleData();
+    for (std::size_t i = 0; i < mutableData.size(); ++i) {
+        if (mutableData.entry_at(i).type == 2) {
+            mutableData.setType(i, 0);
+        }
+    }
+    kernel.stateModel().updateNeighborList();
+    EXPECT_FALSE(pairList.upToDate());
+    forces->perform();
+    std::vector<Vec3> pairListForces;
+    for (const auto &entry : data) {
+        pairListForces.push_back(entry.force);
+    }
+    const auto pairListEnergy = stateModel.energy();
+    pairList.enabled() = false;
+    forces->perform();
+    EXPECT_NEAR(stateModel.energy(), pairListEnergy, 1e-3);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        for (int d = 0; d < 3; ++d) {
+            EXPECT_NEAR(data.entry_at(i).force[d], pairListForces[i][d], 1e-4);
+        }
+    }
+}
+
+TEST(TestNeighborListImpl, MultiResolution) {
+    using namespace readdy;
+
+    kernel::cpu::CPUKernel kernel;
+    auto &context = kernel.context();
+    context.particle_types().add("A", 1.);
+    context.particle_types().add("B", 1.);
+    context.reactions().addFusion("AA", "A", "A", "A", 0., 1.);
+    context.reactions().addFusion("AB", "A", "B", "B", 0., 3.);
+    context.reactions().addFusion("BB", "B", "B", "B", 0., 4.);
+    context.periodicBoundaryConditions() = {{true, true, false}};
+    context.boxSize() = {{12, 10, 8}};
+    for (const auto &type : {"A", "B"}) {
+        context.potentials().addBox(type, 0., {-5.9, -4.9, -3.9}, {11.8, 9.8, 7.8});
+    }
+
+    auto randomPosition = [] {
+        return Vec3(model::rnd::uniform_real<scalar>(-6, 6), model::rnd::uniform_real<scalar>(-5, 5),
+                    model::rnd::uniform_real<scalar>(-4, 4));
+    };
+    for (auto i = 0; i < 400; ++i) {
+        kernel.stateModel().addParticle({randomPosition(), context.particle_types().idOf("A")});
+    }
+    for (auto i = 0; i < 20; ++i) {
+        kernel.stateModel().addParticle({randomPosition(), context.particle_types().idOf("B")});
+    }
+    kernel.initialize();
+
+    auto &neighborList = *kernel.getCPUKernelStateModel().getNeighborList();
+    neighborList.smallCutoff() = 1.;
+    kernel.stateModel().initializeNeighborList(.2);
+    ASSERT_TRUE(neighborList.multiResolution());
+    EXPECT_FALSE(neighborList.largeType(context.particle_types().idOf("A")));
+    EXPECT_TRUE(neighborList.largeType(context.particle_types().idOf("B")));
+
+    auto &data = *kernel.getCPUKernelStateModel().getParticleData();
+    const auto &d2 = context.distSquaredFun();
+    auto cutoff = [&](std::size_t i, std::size_t j) -> scalar {
+        const auto nB = (neighborList.largeType(data.entry_at(i).type) ? 1 : 0)
+                        + (neighborList.largeType(data.entry_at(j).type) ? 1 : 0);
+        return nB == 0 ? 1. : nB == 1 ? 3. : 4.;
+    };
+    // each pair within its cutoff is visited exactly once by the half neighbors and twice by the full neighbors
+    auto check = [&] {
+        expectHalfShellMatchesBruteForce(neighborList, data, d2, cutoff);
+        expectFullShellMatchesBruteForce(neighborList, data, d2, cutoff);
+    };
+    check();
+
+    // incremental edits keep the lists of large particles in sync
+    std::vector<cpu::data::Entry> newEntries;
+    std::vector<std::size_t> removedEntries{0, 401, 405};
+    for (auto i = 0; i < 5; ++i) {
+        newEntries.emplace_back(model::Particle(randomPosition(), context.particle_types().idOf(i < 3 ? "B" : "A")));
+    }
+    data.update(std::make_tuple(std::move(newEntries), std::move(removedEntries)));
+    kernel.stateModel().updateNeighborList();
+    check();
+
+    // so do type changes, converted particles move between the lists of small and large particles
+    const auto typeA = context.particle_types().idOf("A");
+    const auto typeB = context.particle_types().idOf("B");
+    std::size_t nConverted = 0;
+    for (std::size_t index = 0; index < data.size() && nConverted < 20; ++index) {
+        const auto &entry = data.entry_at(index);
+        if (!entry.deactivated) {
+            data.setType(index, entry.type == typeA ? typeB : typeA);
+            ++nConverted;
+        }
+    }
+    kernel.stateModel().updateNeighborList();
+    check();
+
+    // with Verlet lists the same holds for type changes in a step without complete edits, in which the lists
+    // would otherwise be reused
+    neighborList.verlet() = true;
+    data.invalidateEdits();
+    kernel.stateModel().updateNeighborList();
+    ASSERT_TRUE(neighborList.verletValid());
+    nConverted = 0;
+    for (std::size_t index = data.size(); index > 0 && nConverted < 20; --index) {
+        const auto &entry = data.entry_at(index - 1);
+        if (!entry.deactivated && entry.type == typeA) {
+            data.setType(index - 1, typeB);
+            ++nConverted;
+        }
+    }
+    data.invalidateEdits();
+    kernel.stateModel().updateNeighborList();
+    ASSERT_TRUE(neighborList.verletValid());
+    check();
+}
+
+TEST(TestNeighborListImpl, SparseCells) {
+    using namespace readdy;
+
+    kernel::cpu::CPUKernel kernel;
+    auto &context = kernel.context();
+    context.particle_types().add("A", 1.);
+    scalar cutoff = 1.5;
+    context.reactions().addFusion("test", "A", "A", "A", 0., cutoff);
+    context.periodicBoundaryConditions() = {{true, true, false}};
+    context.boxSize() = {{200, 200, 100}};
+    context.potentials().addBox("A", 0., {-99, -99, -49}, {198, 198, 98});
+
+    // a few dense clusters in a mostly empty box, one of them across the periodic boundary
+    auto addCluster = [&](const Vec3 &center) {
+        for (auto i = 0; i < 100; ++i) {
+            Vec3 pos = center + Vec3(model::rnd::uniform_real<scalar>(-3, 3), model::rnd::uniform_real<scalar>(-3, 3),
+                                     model::rnd::uniform_real<scalar>(-3, 3));
+            for (int d = 0; d < 2; ++d) {
+                if (pos[d] >= 100) pos[d] -= 200;
+                if (pos[d] < -100) pos[d] += 200;
+            }
+            kernel.stateModel().addParticle({pos.x, pos.y, pos.z, 0});
+        }
+    };
+    addCluster({0, 0, 0});
+    addCluster({99, -99, 10});
+    addCluster({-50, 30, -40});
+    kernel.initialize();
+
+    auto &neighborList = *kernel.getCPUKernelStateModel().getNeighborList();
+    neighborList.sparse() = true;
+    kernel.stateModel().initializeNeighborList(0);
+
+    auto &data = *kernel.getCPUKernelStateModel().getParticleData();
+    const auto &d2 = context.distSquaredFun();
+    auto check = [&]() {
+        // only occupied cells are materialized
+        ASSERT_GT(neighborList.cellIndex().size(), 1000000);
+        ASSERT_LE(neighborList.nCells(), data.size());
+        for (auto cell = 0_z; cell < neighborList.nCells(); ++cell) {
+            ASSERT_NE(neighborList.particlesBegin(cell), neighborList.particlesEnd(cell));
+        }
+
+        // the colored blocks cover each cell exactly once
+        std::vector<std::size_t> nCovered(neighborList.nCells(), 0);
+        for (std::uint8_t color = 0; color < kernel::cpu::nl::CellLinkedList::nColors; ++color) {
+            for (const auto &block : neighborList.blocksOfColor(color)) {
+                neighborList.forEachCellInBlock(block, [&](std::size_t cell) { ++nCovered[cell]; });
+            }
+        }
+        EXPECT_TRUE(std::all_of(nCovered.begin(), nCovered.end(), [](std::size_t n) { return n == 1; }));
+
+        auto cutoffFn = [=](std::size_t, std::size_t) { return cutoff; };
+        expectHalfShellMatchesBruteForce(neighborList, data, d2, cutoffFn);
+        expectFullShellMatchesBruteForce(neighborList, data, d2, cutoffFn);
+    };
+    check();
+
+    // edits that occupy new cells are picked up
+    std::vector<cpu::data::Entry> newEntries;
+    std::vector<std::size_t> removedEntries{0, 150};
+    newEntries.emplace_back(model::Particle(Vec3(70, 70, 20), 0));
+    newEntries.emplace_back(model::Particle(Vec3(70.5, 70, 20), 0));
+    data.update(std::make_tuple(std::move(newEntries), std::move(removedEntries)));
+    kernel.stateModel().updateNeighborList();
+    check();
+}
+
+TEST(TestNeighborListImpl, Compaction) {
+    using namespace readdy;
+
+    kernel::cpu::CPUKernel kernel;
+    auto &context = kernel.context();
+    context.particle_types().add("A", 1.);
+    context.reactions().addFusion("test", "A", "A", "A", 0., 1.);
+    context.periodicBoundaryConditions() = {{true, true, true}};
+    context.boxSize() = {{10, 8, 6}};
+
+    for (auto i = 0; i < 500; ++i) {
+        kernel.stateModel().addParticle({model::rnd::uniform_real<scalar>(-5, 5),
+                                         model::rnd::uniform_real<scalar>(-4, 4),
+                                         model::rnd::uniform_real<scalar>(-3, 3), 0});
+    }
+    kernel.initialize();
+
+    auto &neighborList = *kernel.getCPUKernelStateModel().getNeighborList();
+    auto &data = *kernel.getCPUKernelStateModel().getParticleData();
+    data.compactionThreshold() = .5;
+    kernel.stateModel().initializeNeighborList(0);
+
+    std::vector<model::Particle::id_type> ids;
+    std::vector<std::size_t> permutation;
+    auto connection = data.registerReorderEventListener([&](const std::vector<std::size_t> &p) {
+        permutation = p;
+        ids.clear();
+        for (const auto &entry : data) {
+            ids.push_back(entry.deactivated ? 0 : entry.id);
+        }
+    });
+
+    // below the threshold nothing happens
+    for (std::size_t i = 0; i < 200; ++i) {
+        data.removeEntry(2 * i);
+    }
+    data.invalidateEdits();
+    kernel.stateModel().updateNeighborList();
+    EXPECT_TRUE(permutation.empty());
+    EXPECT_EQ(data.size(), 500);
+
+    for (std::size_t i = 0; i < 100; ++i) {
+        data.removeEntry(2 * i + 1);
+    }
+    std::vector<model::Particle::id_type> remaining;
+    for (const auto &entry : data) {
+        if (!entry.deactivated) remaining.push_back(entry.id);
+    }
+    data.invalidateEdits();
+    kernel.stateModel().updateNeighborList();
+    ASSERT_EQ(permutation.size(), 500);
+
+    // the permutation maps old onto new indices, the active entries keep their order and no blanks are left
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        if (ids[i] != 0) {
+            EXPECT_EQ(data.entry_at(permutation[i]).id, ids[i]);
+        } else {
+            EXPECT_GE(permutation[i], remaining.size());
+        }
+    }
+    ASSERT_EQ(data.size(), remaining.size());
+    EXPECT_EQ(data.getNDeactivated(), 0);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        EXPECT_EQ(data.entry_at(i).id, remaining[i]);
+    }
+
+    // and the bins refer to the compacted data
+    std::size_t nBinned = 0;
+    for (auto cell = 0_z; cell < neighborList.nCells(); ++cell) {
+        for (auto it = neighborList.particlesBegin(cell); it != neighborList.particlesEnd(cell); ++it) {
+            EXPECT_EQ(neighborList.cellOfParticle(*it), cell);
+            ++nBinned;
+        }
+    }
+    EXPECT_EQ(nBinned, data.size());
+}
+
 class TestCPUNeighborList : public ::testing::TestWithParam<std::array<readdy::scalar, 3>> {
 public:
 
@@ -70,6 +70,7 @@ void Simulation::run(const time_step_type steps, const scalar timeStep) {
             log::debug("\t {}", p);
         }
     }
+    pimpl->kernel->tune(timeStep, pimpl->performanceRoot.subnode("tune"));
     runScheme().configure(timeStep)->run(steps);
 }
 
@@ -101,6 +102,25 @@ void Simulation::addParticle(const std::string &type, scalar x, scalar y, scalar
 
 }
 
+void Simulation::addParticles(const std::string &type, const std::vector<Vec3> &positions) {
+    ensureKernelSelected();
+    const auto &&s = getBoxSize();
+    auto inBox = [&s](const Vec3 &pos) {
+        return fabs(pos.x) <= .5 * s[0] && fabs(pos.y) <= .5 * s[1] && fabs(pos.z) <= .5 * s[2];
+    };
+    const auto typeId = pimpl->kernel->context().particle_types().idOf(type);
+    if (std::all_of(positions.begin(), positions.end(), inBox)) {
+        pimpl->kernel->stateModel().addParticles(typeId, positions);
+    } else {
+        std::vector<Vec3> valid;
+        valid.reserve(positions.size());
+        std::copy_if(positions.begin(), positions.end(), std::back_inserter(valid), inBox);
+        log::error("{} particle positions were not in bounds of the simulation box!",
+                   positions.size() - valid.size());
+        pimpl->kernel->stateModel().addParticles(typeId, valid);
+    }
+}
+
 particle_type_type
 Simulation::registerParticleType(const std::string &name, const scalar diffusionCoefficient,
                                  readdy::model::particle_flavor flavor) {
@@ -379,6 +399,11 @@ std::vector<model::Particle> Simulation::getParticlesForTopology(const model::to
     return getSelectedKernel()->stateModel().getParticlesForTopology(topology);
 }
 
+std::vector<model::Particle> Simulation::getParticlesForIds(const std::vector<model::Particle::id_type> &ids) const {
+    ensureKernelSelected();
+    return getSelectedKernel()->stateModel().getParticlesForIds(ids);
+}
+
 bool Simulation::singlePrecision() const {
     ensureKernelSelected();
     return pimpl->kernel->singlePrecision();
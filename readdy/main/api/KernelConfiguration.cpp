@@ -36,11 +36,70 @@ namespace conf {
 
 namespace cpu {
 void to_json(json &j, const NeighborList &nl) {
-    j = json{{"cll_radius", nl.cll_radius}};
+    j = json{{"cll_radius", nl.cll_radius}, {"verlet", nl.verlet}, {"hilbert_sort_interval", nl.hilbert_sort_interval},
+             {"hilbert_sort_threshold", nl.hilbert_sort_threshold}, {"compaction_threshold", nl.compaction_threshold},
+             {"sort_by_cell", nl.sort_by_cell}, {"small_cutoff", nl.small_cutoff}, {"pair_list", nl.pair_list},
+             {"sparse_cells", nl.sparse_cells}, {"skin", nl.skin}, {"auto_tune", nl.auto_tune},
+             {"auto_tune_steps", nl.auto_tune_steps}};
 }
 
 void from_json(const json &j, NeighborList &nl) {
     nl.cll_radius = j.at("cll_radius").get<std::uint8_t>();
+    if (j.find("verlet") != j.end()) {
+        nl.verlet = j.at("verlet").get<bool>();
+    } else {
+        nl.verlet = false;
+    }
+    if (j.find("hilbert_sort_interval") != j.end()) {
+        nl.hilbert_sort_interval = j.at("hilbert_sort_interval").get<std::uint32_t>();
+    } else {
+        nl.hilbert_sort_interval = 0;
+    }
+    if (j.find("hilbert_sort_threshold") != j.end()) {
+        nl.hilbert_sort_threshold = j.at("hilbert_sort_threshold").get<double>();
+    } else {
+        nl.hilbert_sort_threshold = 1;
+    }
+    if (j.find("compaction_threshold") != j.end()) {
+        nl.compaction_threshold = j.at("compaction_threshold").get<double>();
+    } else {
+        nl.compaction_threshold = 1;
+    }
+    if (j.find("sort_by_cell") != j.end()) {
+        nl.sort_by_cell = j.at("sort_by_cell").get<bool>();
+    } else {
+        nl.sort_by_cell = false;
+    }
+    if (j.find("small_cutoff") != j.end()) {
+        nl.small_cutoff = j.at("small_cutoff").get<double>();
+    } else {
+        nl.small_cutoff = 0;
+    }
+    if (j.find("pair_list") != j.end()) {
+        nl.pair_list = j.at("pair_list").get<bool>();
+    } else {
+        nl.pair_list = false;
+    }
+    if (j.find("sparse_cells") != j.end()) {
+        nl.sparse_cells = j.at("sparse_cells").get<bool>();
+    } else {
+        nl.sparse_cells = false;
+    }
+    if (j.find("skin") != j.end()) {
+        nl.skin = j.at("skin").get<double>();
+    } else {
+        nl.skin = 0;
+    }
+    if (j.find("auto_tune") != j.end()) {
+        nl.auto_tune = j.at("auto_tune").get<bool>();
+    } else {
+        nl.auto_tune = false;
+    }
+    if (j.find("auto_tune_steps") != j.end()) {
+        nl.auto_tune_steps = j.at("auto_tune_steps").get<std::uint32_t>();
+    } else {
+        nl.auto_tune_steps = 10;
+    }
 }
 
 void to_json(json &j, const ThreadConfig &nl) {
@@ -55,9 +114,27 @@ void from_json(const json &j, ThreadConfig &nl) {
     }
 }
 
+void to_json(json &j, const ParticleData &pd) {
+    j = json{{"index_ids", pd.index_ids}, {"id_block_size", pd.id_block_size}};
+}
+
+void from_json(const json &j, ParticleData &pd) {
+    if (j.find("index_ids") != j.end()) {
+        pd.index_ids = j.at("index_ids").get<bool>();
+    } else {
+        pd.index_ids = false;
+    }
+    if (j.find("id_block_size") != j.end()) {
+        pd.id_block_size = j.at("id_block_size").get<std::uint32_t>();
+    } else {
+        pd.id_block_size = 1024;
+    }
+}
+
 void to_json(json &j, const Configuration &conf) {
     j = json {{"neighbor_list", conf.neighborList},
-              {"thread_config", conf.threadConfig}};
+              {"thread_config", conf.threadConfig},
+              {"particle_data", conf.particleData}};
 }
 
 void from_json(const json &j, Configuration &conf) {
@@ -71,6 +148,11 @@ void from_json(const json &j, Configuration &conf) {
     } else {
         conf.threadConfig = {};
     }
+    if (j.find("particle_data") != j.end()) {
+        conf.particleData = j.at("particle_data").get<ParticleData>();
+    } else {
+        conf.particleData = {};
+    }
 }
 }
 
@@ -214,5 +214,33 @@ const scalar Context::calculateMaxCutoff() const {
     return max_cutoff;
 }
 
+const util::particle_type_pair_unordered_map<scalar> Context::calculateMaxCutoffs() const {
+    util::particle_type_pair_unordered_map<scalar> cutoffs;
+    auto update = [&cutoffs](particle_type_type type1, particle_type_type type2, scalar cutoff) {
+        auto it = cutoffs.find(std::make_tuple(type1, type2));
+        if (it == cutoffs.end()) {
+            cutoffs.emplace(std::make_tuple(type1, type2), cutoff);
+        } else {
+            it->second = std::max(it->second, cutoff);
+        }
+    };
+    for (const auto &entry : potentials().potentialsOrder2()) {
+        for (const auto &potential : entry.second) {
+            update(std::get<0>(entry.first), std::get<1>(entry.first), potential->getCutoffRadius());
+        }
+    }
+    for (const auto &entry : reactions().order2()) {
+        for (const auto &reaction : entry.second) {
+            update(reaction->educts()[0], reaction->educts()[1], reaction->eductDistance());
+        }
+    }
+    for (const auto &entry : _topologyRegistry.spatialReactionRegistry()) {
+        for (const auto &reaction : entry.second) {
+            update(reaction.type1(), reaction.type2(), reaction.radius());
+        }
+    }
+    return cutoffs;
+}
+
 }
 }
@@ -30,6 +30,7 @@
  * @copyright GNU Lesser General Public License v3.0
  */
 
+#include <unordered_map>
 #include <readdy/model/StateModel.h>
 
 namespace readdy {
@@ -44,5 +45,34 @@ std::vector<Particle> StateModel::getParticlesForTopology(const top::GraphTopolo
     return result;
 }
 
+void StateModel::addParticles(particle_type_type type, const std::vector<Vec3> &positions) {
+    std::vector<Particle> particles;
+    particles.reserve(positions.size());
+    auto id = Particle::nextIds(positions.size());
+    for(const auto &pos : positions) {
+        particles.emplace_back(pos, type, id++);
+    }
+    addParticles(particles);
+}
+
+std::vector<Particle> StateModel::getParticlesForIds(const std::vector<Particle::id_type> &ids) const {
+    const auto particles = getParticles();
+    std::unordered_map<Particle::id_type, std::size_t> indices;
+    indices.reserve(particles.size());
+    for(std::size_t i = 0; i < particles.size(); ++i) {
+        indices.emplace(particles[i].getId(), i);
+    }
+    std::vector<Particle> result;
+    result.reserve(ids.size());
+    for(auto id : ids) {
+        const auto it = indices.find(id);
+        if(it == indices.end()) {
+            throw std::out_of_range("requested id was not to be found in particle data");
+        }
+        result.push_back(particles[it->second]);
+    }
+    return result;
+}
+
 }
 }
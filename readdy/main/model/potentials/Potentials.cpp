@@ -222,6 +222,78 @@ std::string ScreenedElectrostatics::type() const {
     return getPotentialName<ScreenedElectrostatics>();
 }
 
+/**
+ * Tabulated potential
+ */
+
+TabulatedPotential::TabulatedPotential(particle_type_type type1, particle_type_type type2, scalar cutoff,
+                                       const radial_function &energy, const radial_function &force,
+                                       std::size_t nPoints, Interpolation interpolation)
+        : super(type1, type2), cutoff(cutoff), cutoffSquared(cutoff * cutoff), nIntervals(nPoints - 1),
+          inverseSpacing(static_cast<scalar>(nPoints - 1) / (cutoff * cutoff)), interpolation(interpolation),
+          source("user-defined radial functions") {
+    if (nPoints < 2) {
+        throw std::invalid_argument("a tabulated potential needs at least two grid points!");
+    }
+    if (cutoff <= 0) {
+        throw std::invalid_argument("the cutoff of a tabulated potential must be positive!");
+    }
+    sample([&energy, &force](scalar r, scalar &e, scalar &forceFactor) {
+        e = energy(r);
+        forceFactor = -force(r) / r;
+    });
+}
+
+TabulatedPotential::TabulatedPotential(const PotentialOrder2 &potential, std::size_t nPoints,
+                                       Interpolation interpolation)
+        : super(potential.particleType1(), potential.particleType2()), cutoff(potential.getCutoffRadius()),
+          cutoffSquared(potential.getCutoffRadiusSquared()), nIntervals(nPoints - 1),
+          inverseSpacing(static_cast<scalar>(nPoints - 1) / potential.getCutoffRadiusSquared()),
+          interpolation(interpolation), source(potential.describe()) {
+    if (nPoints < 2) {
+        throw std::invalid_argument("a tabulated potential needs at least two grid points!");
+    }
+    if (cutoff <= 0) {
+        throw std::invalid_argument("the cutoff of a tabulated potential must be positive!");
+    }
+    sample([&potential](scalar r, scalar &e, scalar &forceFactor) {
+        Vec3 force{0, 0, 0};
+        e = 0;
+        potential.calculateForceAndEnergy(force, e, {r, 0, 0});
+        forceFactor = force.x / r;
+    });
+}
+
+void TabulatedPotential::sample(const std::function<void(scalar, scalar &, scalar &)> &evaluate) {
+    const auto n = nIntervals + 1;
+    energies.resize(n + 2);
+    forceFactors.resize(n + 2);
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto distSquared = static_cast<scalar>(i) / inverseSpacing;
+        evaluate(std::sqrt(distSquared), energies[i + 1], forceFactors[i + 1]);
+    }
+    // singularities (typically at r = 0) are replaced by the next regular sample
+    for (auto i = n; i > 0; --i) {
+        if (!std::isfinite(energies[i])) energies[i] = i < n ? energies[i + 1] : 0;
+        if (!std::isfinite(forceFactors[i])) forceFactors[i] = i < n ? forceFactors[i + 1] : 0;
+    }
+    // ghost points by linear extrapolation
+    energies[0] = c_::two * energies[1] - energies[2];
+    forceFactors[0] = c_::two * forceFactors[1] - forceFactors[2];
+    energies[n + 1] = c_::two * energies[n] - energies[n - 1];
+    forceFactors[n + 1] = c_::two * forceFactors[n] - forceFactors[n - 1];
+}
+
+std::string TabulatedPotential::describe() const {
+    return fmt::format("Tabulated potential with {} grid points in r^2, {} interpolation, and cutoff={}, sampled "
+                               "from {}", nPoints(), interpolation == Interpolation::LINEAR ? "linear" : "cubic",
+                       cutoff, source);
+}
+
+std::string TabulatedPotential::type() const {
+    return getPotentialName<TabulatedPotential>();
+}
+
 }
 }
 }
@@ -31,6 +31,7 @@
 
 
 #include <readdy/common/Utils.h>
+#include <readdy/common/boundary_condition_operations.h>
 #include <readdy/common/make_unique.h>
 #include <readdy/model/Kernel.h>
 #include <readdy/plugin/KernelProvider.h>
@@ -80,6 +81,26 @@ TEST_F(TestKernelContext, DistanceFunctions) {
     EXPECT_NEAR(distSquared(v1, v2), 2., 1e-9);
 }
 
+TEST_F(TestKernelContext, DispatchPeriodicBoundaries) {
+    readdy::Vec3 v1(-1.9, 1.8, -1.7);
+    readdy::Vec3 v2(+1.5, -1.6, +1.9);
+    for (int combination = 0; combination < 8; ++combination) {
+        m::Context ctx;
+        ctx.periodicBoundaryConditions() = {{(combination & 1) != 0, (combination & 2) != 0, (combination & 4) != 0}};
+        ctx.boxSize() = {{4, 4, 4}};
+        ctx.configure();
+        readdy::bcs::dispatchPeriodicBoundaries(ctx.periodicBoundaryConditions(), [&](auto boundaries) {
+            using boundaries_t = decltype(boundaries);
+            EXPECT_EQ(boundaries_t::x, ctx.periodicBoundaryConditions()[0]);
+            EXPECT_EQ(boundaries_t::y, ctx.periodicBoundaryConditions()[1]);
+            EXPECT_EQ(boundaries_t::z, ctx.periodicBoundaryConditions()[2]);
+            EXPECT_EQ(boundaries_t::distSquared(v1, v2, ctx.boxSize()), ctx.distSquaredFun()(v1, v2));
+            EXPECT_EQ(boundaries_t::shortestDifference(v1, v2, ctx.boxSize()), ctx.shortestDifferenceFun()(v1, v2));
+            EXPECT_EQ(boundaries_t::applyPBC(v2 + v2, ctx.boxSize()), ctx.applyPBCFun()(v2 + v2));
+        });
+    }
+}
+
 TEST_F(TestKernelContext, BoxSize) {
     m::Context ctx;
     ctx.boxSize() = {{10, 11, 12}};
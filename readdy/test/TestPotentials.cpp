@@ -369,6 +369,174 @@ TEST_P(TestPotentials, SphericalBarrier) {
     EXPECT_VEC3_NEAR(collectedForces[id1Idx], forceOnParticle1, kernel->doublePrecision() ? 1e-8 : 1e-5);
 }
 
+TEST(TestPotentialsTable, AgreesWithVirtualEvaluation) {
+    using namespace readdy;
+    model::Context ctx;
+    ctx.particle_types().add("A", 1.0);
+    ctx.particle_types().add("B", 1.0);
+    ctx.particle_types().add("C", 1.0);
+    auto &potentials = ctx.potentials();
+    potentials.addHarmonicRepulsion("A", "A", 10., 1.2);
+    potentials.addWeakInteractionPiecewiseHarmonic("A", "B", 10., .8, 1., 1.4);
+    potentials.addLennardJones("B", "B", 12, 6, 1.5, true, 1., .5);
+    potentials.addLennardJones("B", "C", 9, 3, 1.5, false, 2., .6);
+    potentials.addScreenedElectrostatics("A", "C", 1., 1., .5, .3, 6, 1.3);
+    potentials.addHarmonicRepulsion("C", "A", 5., .9);
+    ctx.configure();
+
+    const auto &table = potentials.tableOrder2();
+    for (const auto &t1 : {"A", "B", "C"}) {
+        for (const auto &t2 : {"A", "B", "C"}) {
+            const auto &pots = potentials.potentialsOf(t1, t2);
+            auto begin = table.begin(ctx.particle_types().idOf(t1), ctx.particle_types().idOf(t2));
+            auto end = table.end(ctx.particle_types().idOf(t1), ctx.particle_types().idOf(t2));
+            ASSERT_EQ(static_cast<std::size_t>(std::distance(begin, end)), pots.size());
+            for (auto r = static_cast<scalar>(.25); r < 1.6; r += .05) {
+                Vec3 x_ij{r / std::sqrt(c_::three), -r / std::sqrt(c_::three), r / std::sqrt(c_::three)};
+                auto distSquared = x_ij * x_ij;
+                auto itDescriptor = begin;
+                for (const auto potential : pots) {
+                    if (distSquared < potential->getCutoffRadiusSquared()) {
+                        Vec3 forceVirtual{0, 0, 0}, forceTable{0, 0, 0};
+                        scalar energyVirtual{0}, energyTable{0};
+                        potential->calculateForceAndEnergy(forceVirtual, energyVirtual, x_ij);
+                        model::potentials::calculateForceAndEnergy(*itDescriptor, forceTable, energyTable, x_ij,
+                                                                   distSquared);
+                        EXPECT_NEAR(energyVirtual, energyTable, 1e-8 * std::max(c_::one, std::abs(energyVirtual)));
+                        EXPECT_VEC3_NEAR(forceVirtual, forceTable, 1e-8 * std::max(c_::one, forceVirtual.norm()));
+                    }
+                    EXPECT_EQ(itDescriptor->cutoffSquared, potential->getCutoffRadiusSquared());
+                    ++itDescriptor;
+                }
+            }
+        }
+    }
+}
+
+TEST(TestPotentialsTable, ExternalAgreesWithVirtualEvaluation) {
+    using namespace readdy;
+    model::Context ctx;
+    ctx.particle_types().add("A", 1.0);
+    ctx.particle_types().add("B", 1.0);
+    ctx.particle_types().add("C", 1.0);
+    auto &potentials = ctx.potentials();
+    potentials.addBox("A", 10., {-1, -1, -1}, {2, 2, 2});
+    potentials.addSphereIn("A", 5., {.1, .2, .3}, .7);
+    potentials.addSphereOut("B", 5., {-.1, .2, 0}, .9);
+    potentials.addSphericalBarrier("B", 2., .3, {0, 0, 0}, .8);
+    potentials.addBox("C", 3., {-.5, -.5, -.5}, {1, 1, 1});
+    ctx.configure();
+
+    const auto &table = potentials.tableOrder1();
+    std::vector<Vec3> positions;
+    for (auto x = static_cast<scalar>(-1.4); x < 1.5; x += .2) {
+        for (auto y = static_cast<scalar>(-1.3); y < 1.5; y += .3) {
+            positions.emplace_back(x, y, static_cast<scalar>(.5) * (x - y));
+        }
+    }
+    std::vector<scalar> xs, ys, zs;
+    for (const auto &pos : positions) {
+        xs.push_back(pos.x);
+        ys.push_back(pos.y);
+        zs.push_back(pos.z);
+    }
+    for (const auto &t : {"A", "B", "C"}) {
+        const auto &pots = potentials.potentialsOf(t);
+        auto begin = table.begin(ctx.particle_types().idOf(t));
+        auto end = table.end(ctx.particle_types().idOf(t));
+        ASSERT_EQ(static_cast<std::size_t>(std::distance(begin, end)), pots.size());
+        const auto n = positions.size();
+        std::vector<scalar> fx(n, 0), fy(n, 0), fz(n, 0), energies(n, 0);
+        for (auto it = begin; it != end; ++it) {
+            model::potentials::calculateForcesAndEnergies(*it, n, xs.data(), ys.data(), zs.data(),
+                                                          fx.data(), fy.data(), fz.data(), energies.data());
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            Vec3 forceVirtual{0, 0, 0};
+            scalar energyVirtual{0};
+            for (const auto potential : pots) {
+                potential->calculateForceAndEnergy(forceVirtual, energyVirtual, positions[i]);
+            }
+            Vec3 forceTable{fx[i], fy[i], fz[i]};
+            EXPECT_NEAR(energyVirtual, energies[i], 1e-8 * std::max(c_::one, std::abs(energyVirtual)));
+            EXPECT_VEC3_NEAR(forceVirtual, forceTable, 1e-8 * std::max(c_::one, forceVirtual.norm()));
+        }
+    }
+}
+
+TEST(TestPotentialsTable, InteractingTypes) {
+    using namespace readdy;
+    model::Context ctx;
+    ctx.particle_types().add("A", 1.0);
+    ctx.particle_types().add("B", 1.0);
+    ctx.particle_types().add("C", 1.0);
+    ctx.particle_types().add("T", 1.0, model::particleflavor::TOPOLOGY);
+    auto &potentials = ctx.potentials();
+    potentials.addBox("A", 10., {-1, -1, -1}, {2, 2, 2});
+    potentials.addHarmonicRepulsion("B", "B", 10., 1.2);
+    ctx.configure();
+
+    const auto &types = ctx.particle_types();
+    EXPECT_TRUE(potentials.interacting(types.idOf("A")));
+    EXPECT_TRUE(potentials.interacting(types.idOf("B")));
+    EXPECT_FALSE(potentials.interacting(types.idOf("C")));
+    EXPECT_TRUE(potentials.interacting(types.idOf("T")));
+    EXPECT_FALSE(potentials.tableOrder2().interacts(types.idOf("A")));
+    EXPECT_TRUE(potentials.tableOrder2().interacts(types.idOf("B")));
+    EXPECT_FALSE(potentials.tableOrder2().interacts(types.idOf("T")));
+}
+
+TEST(TestPotentialsTable, TabulatedAgreesWithAnalytic) {
+    using namespace readdy;
+    using interp = model::potentials::TabulatedPotential::Interpolation;
+    model::potentials::LennardJones lj(0, 0, 12, 6, 2.5, true, 1., 1.);
+    model::potentials::ScreenedElectrostatics se(0, 0, 1., 1., .5, .3, 6, 2.);
+    for (const model::potentials::PotentialOrder2 *potential : {static_cast<model::potentials::PotentialOrder2*>(&lj),
+                                                                 static_cast<model::potentials::PotentialOrder2*>(&se)}) {
+        for (auto interpolation : {interp::LINEAR, interp::CUBIC}) {
+            model::potentials::TabulatedPotential tabulated(*potential, 5000, interpolation);
+            EXPECT_EQ(tabulated.getCutoffRadiusSquared(), potential->getCutoffRadiusSquared());
+            auto tolerance = interpolation == interp::CUBIC ? 1e-5 : 1e-3;
+            for (auto r = static_cast<scalar>(.9); r < potential->getCutoffRadius(); r += .01) {
+                Vec3 x_ij{r / std::sqrt(c_::three), -r / std::sqrt(c_::three), r / std::sqrt(c_::three)};
+                Vec3 forceAnalytic{0, 0, 0}, forceTabulated{0, 0, 0};
+                scalar energyAnalytic{0}, energyTabulated{0};
+                potential->calculateForceAndEnergy(forceAnalytic, energyAnalytic, x_ij);
+                tabulated.calculateForceAndEnergy(forceTabulated, energyTabulated, x_ij);
+                EXPECT_NEAR(energyAnalytic, energyTabulated, tolerance * std::max(c_::one, std::abs(energyAnalytic)));
+                EXPECT_VEC3_NEAR(forceAnalytic, forceTabulated, tolerance * std::max(c_::one, forceAnalytic.norm()));
+            }
+        }
+    }
+}
+
+TEST(TestPotentialsTable, TabulateOnConfigure) {
+    using namespace readdy;
+    model::Context ctx;
+    ctx.particle_types().add("A", 1.0);
+    auto &potentials = ctx.potentials();
+    auto id = potentials.addHarmonicRepulsion("A", "A", 10., 1.2);
+    potentials.tabulate(id, 100, model::potentials::TabulatedPotential::Interpolation::LINEAR);
+    ctx.configure();
+    const auto &pots = potentials.potentialsOf("A", "A");
+    ASSERT_EQ(pots.size(), 1);
+    EXPECT_EQ(pots.front()->type(), "TabulatedPotential");
+    auto typeId = ctx.particle_types().idOf("A");
+    auto begin = potentials.tableOrder2().begin(typeId, typeId);
+    ASSERT_EQ(std::distance(begin, potentials.tableOrder2().end(typeId, typeId)), 1);
+    EXPECT_EQ(begin->kind, model::potentials::PairPotentialKind::TABULATED);
+    // harmonic repulsion is quadratic in r, not in r^2, the linear interpolation is only approximately exact
+    Vec3 force{0, 0, 0};
+    scalar energy{0};
+    model::potentials::calculateForceAndEnergy(*begin, force, energy, {.5, 0, 0}, .25);
+    EXPECT_NEAR(energy, .5 * 10. * .7 * .7, 1e-2);
+    EXPECT_NEAR(force.x, -10. * .7, 1e-1);
+
+    potentials.remove(id);
+    ctx.configure();
+    EXPECT_TRUE(potentials.potentialsOf("A", "A").empty());
+}
+
 INSTANTIATE_TEST_CASE_P(TestPotentials, TestPotentials,
                         ::testing::ValuesIn(readdy::testing::getKernelsToTest()));
 }
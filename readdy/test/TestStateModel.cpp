@@ -240,6 +240,44 @@ TEST_P(TestStateModel, CalculateForcesNoForces) {
     }
 }
 
+TEST_P(TestStateModel, ParticlesForIds) {
+    m::Context &ctx = kernel->context();
+    auto &stateModel = kernel->stateModel();
+    ctx.particle_types().add("A", 1.0);
+    ctx.particle_types().add("B", 1.0);
+    ctx.boxSize() = {{10., 10., 10.}};
+    ctx.configure();
+    kernel->initialize();
+
+    std::vector<m::Particle> particles;
+    for (auto i = 0; i < 20; ++i) {
+        particles.emplace_back(i * .1, 0, 0, ctx.particle_types().idOf(i % 2 == 0 ? "A" : "B"));
+    }
+    stateModel.addParticles(particles);
+    stateModel.removeParticle(particles.at(3));
+
+    std::vector<m::Particle::id_type> ids{particles.at(7).getId(), particles.at(0).getId(), particles.at(19).getId()};
+    auto result = stateModel.getParticlesForIds(ids);
+    ASSERT_EQ(result.size(), ids.size());
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        EXPECT_EQ(result.at(i).getId(), ids.at(i));
+    }
+    EXPECT_EQ(result.at(0).getType(), ctx.particle_types().idOf("B"));
+    EXPECT_VEC3_EQ(result.at(0).getPos(), particles.at(7).getPos());
+
+    // the lookup stays valid when particles are added and removed afterwards
+    stateModel.removeParticle(particles.at(0));
+    m::Particle added(1., 1., 1., ctx.particle_types().idOf("A"));
+    stateModel.addParticle(added);
+    result = stateModel.getParticlesForIds({added.getId(), particles.at(19).getId()});
+    EXPECT_EQ(result.at(0).getId(), added.getId());
+    EXPECT_VEC3_EQ(result.at(0).getPos(), added.getPos());
+    EXPECT_EQ(result.at(1).getId(), particles.at(19).getId());
+
+    EXPECT_THROW(stateModel.getParticlesForIds({particles.at(3).getId()}), std::out_of_range);
+    EXPECT_THROW(stateModel.getParticlesForIds({particles.at(0).getId()}), std::out_of_range);
+}
+
 INSTANTIATE_TEST_CASE_P(TestStateModel, TestStateModel,
                         ::testing::ValuesIn(readdy::testing::getKernelsToTest()));
 }
\ No newline at end of file
@@ -24,6 +24,8 @@ CMAKE_FLAGS+=" -DREADDY_LOG_CMAKE_CONFIGURATION:BOOL=ON"
 # enable testing and install test target
 CMAKE_FLAGS+=" -DREADDY_CREATE_TEST_TARGET:BOOL=ON"
 CMAKE_FLAGS+=" -DREADDY_INSTALL_UNIT_TEST_EXECUTABLE:BOOL=OFF"
+# double precision positions and forces
+CMAKE_FLAGS+=" -DREADDY_SINGLE_PRECISION:BOOL=OFF"
 
 if [ $1 = "clang" ]
 then
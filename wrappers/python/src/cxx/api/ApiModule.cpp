@@ -108,9 +108,12 @@ void exportApi(py::module &api) {
             }, "type"_a, "pos"_a)
             .def("add_particles", [](sim &self, const std::string &type, const py::array_t<readdy::scalar> &particles) {
                 auto nParticles = particles.shape(0);
+                std::vector<readdy::Vec3> positions;
+                positions.reserve(static_cast<std::size_t>(nParticles));
                 for(std::size_t i = 0; i < nParticles; ++i) {
-                    self.addParticle(type, particles.at(i, 0), particles.at(i, 1), particles.at(i, 2));
+                    positions.emplace_back(particles.at(i, 0), particles.at(i, 1), particles.at(i, 2));
                 }
+                self.addParticles(type, positions);
             })
             .def("set_kernel_config", &sim::setKernelConfiguration)
             .def("is_kernel_selected", &sim::isKernelSelected)
@@ -167,6 +170,7 @@ void exportApi(py::module &api) {
             })
             .def("register_structural_topology_reaction", &sim::registerStructuralTopologyReaction)
             .def("get_particles_for_topology", &sim::getParticlesForTopology, "topology"_a)
+            .def("get_particles_for_ids", &sim::getParticlesForIds, "ids"_a)
             .def("add_topology", [](sim &self, const std::string &name,
                                     const std::vector<readdy::model::TopologyParticle> &particles) {
                 return self.addTopology(name, particles);
@@ -220,7 +224,8 @@ void exportApi(py::module &api) {
             .def("available_kernels", &kp::availableKernels);
 
     py::class_<pot2>(api, "Pot2")
-            .def(py::init<readdy::particle_type_type, readdy::particle_type_type, py::object, py::object>())
+            .def(py::init<readdy::particle_type_type, readdy::particle_type_type, py::object, py::object,
+                    readdy::scalar>(), "type1"_a, "type2"_a, "energy"_a, "force"_a, "cutoff"_a = 50)
             .def("calc_energy", &pot2::calculateEnergy, "x_ij"_a)
             .def("calc_force", &pot2::calculateForce, "force"_a, "x_ij"_a);
 
@@ -124,7 +124,15 @@ void exportKernelContext(py::module &module) {
             })
             .def("add_external_order2", [](PotentialRegistry& self, readdy::model::potentials::PotentialOrder2& pot) {
                 return self.addUserDefined(&pot);
-            });
+            })
+            .def("tabulate", [](PotentialRegistry &self, readdy::model::potentials::Potential::id_type handle,
+                                std::size_t nPoints, const std::string &interpolation) {
+                using interp = readdy::model::potentials::TabulatedPotential::Interpolation;
+                if (interpolation != "linear" && interpolation != "cubic") {
+                    throw std::invalid_argument("only supported interpolations: \"linear\", \"cubic\"");
+                }
+                self.tabulate(handle, nPoints, interpolation == "linear" ? interp::LINEAR : interp::CUBIC);
+            }, "handle"_a, "n_points"_a = 1000, "interpolation"_a = "cubic");
 
     py::class_<readdy::api::Bond>(module, "BondedPotentialConfiguration")
             .def(py::init([](scalar forceConstant, scalar length, const std::string &type) {
@@ -35,14 +35,14 @@ namespace readdy {
 
 namespace rpy {
 PotentialOrder2Wrapper::PotentialOrder2Wrapper(particle_type_type particleType1, particle_type_type particleType2,
-                                               pybind11::object o1, pybind11::object o2)
+                                               pybind11::object o1, pybind11::object o2, readdy::scalar cutoff)
         : PotentialOrder2(particleType1, particleType2), calcEnergyFun(new pybind11::object(o1), [](pybind11::object *o) {
                       pybind11::gil_scoped_acquire lock;
                       delete o;
                   }), calcForceFun(new pybind11::object(o2), [](pybind11::object *o) {
                       pybind11::gil_scoped_acquire lock;
                       delete o;
-                  }) {}
+                  }), cutoff(cutoff) {}
 
 readdy::scalar PotentialOrder2Wrapper::calculateEnergy(const Vec3 &x_ij) const {
     pybind11::gil_scoped_acquire lock;
@@ -42,7 +42,7 @@ public:
     std::string describe() const override;
 
     PotentialOrder2Wrapper(particle_type_type particleType1, particle_type_type particleType2,
-                           pybind11::object o1, pybind11::object o2);
+                           pybind11::object o1, pybind11::object o2, readdy::scalar cutoff = 50);
 
     readdy::scalar calculateEnergy(const Vec3 &x_ij) const override;
 
@@ -51,8 +51,7 @@ public:
     void calculateForceAndEnergy(Vec3 &force, readdy::scalar &energy, const Vec3 &x_ij) const override;
 
     readdy::scalar getCutoffRadius() const override {
-        // todo!
-        return 50;
+        return cutoff;
     }
 
     readdy::scalar getMaximalForce(readdy::scalar kbt) const noexcept override {
@@ -67,6 +66,7 @@ public:
 protected:
     std::shared_ptr<pybind11::object> calcEnergyFun;
     std::shared_ptr<pybind11::object> calcForceFun;
+    readdy::scalar cutoff;
 };
 }
 }
@@ -34,7 +34,20 @@ class NOOPKernelConfiguration(object):
 class CPUKernelConfiguration(object):
     def __init__(self):
         self._n_threads = -1
+        self._id_block_size = 1024
+        self._index_ids = False
         self._cll_radius = 1
+        self._verlet = False
+        self._hilbert_sort_interval = 0
+        self._hilbert_sort_threshold = 1.
+        self._compaction_threshold = 1.
+        self._sort_by_cell = False
+        self._small_cutoff = 0.
+        self._pair_list = False
+        self._sparse_cells = False
+        self._skin = 0.
+        self._auto_tune = False
+        self._auto_tune_steps = 10
 
     @property
     def n_threads(self):
@@ -44,6 +57,24 @@ class CPUKernelConfiguration(object):
     def n_threads(self, value):
         self._n_threads = value
 
+    @property
+    def id_block_size(self):
+        return self._id_block_size
+
+    @id_block_size.setter
+    def id_block_size(self, value):
+        if value <= 0:
+            raise ValueError("Only strictly positive id block sizes permitted!")
+        self._id_block_size = value
+
+    @property
+    def index_ids(self):
+        return self._index_ids
+
+    @index_ids.setter
+    def index_ids(self, value):
+        self._index_ids = value
+
     @property
     def cell_linked_list_radius(self):
         return self._cll_radius
@@ -54,14 +85,125 @@ class CPUKernelConfiguration(object):
             raise ValueError("Only strictly positive cell linked list radii permitted!")
         self._cll_radius = value
 
+    @property
+    def verlet_list(self):
+        return self._verlet
+
+    @verlet_list.setter
+    def verlet_list(self, value):
+        self._verlet = value
+
+    @property
+    def hilbert_sort_interval(self):
+        return self._hilbert_sort_interval
+
+    @hilbert_sort_interval.setter
+    def hilbert_sort_interval(self, value):
+        if value < 0:
+            raise ValueError("Only non-negative hilbert sort intervals permitted!")
+        self._hilbert_sort_interval = value
+
+    @property
+    def hilbert_sort_threshold(self):
+        return self._hilbert_sort_threshold
+
+    @hilbert_sort_threshold.setter
+    def hilbert_sort_threshold(self, value):
+        self._hilbert_sort_threshold = value
+
+    @property
+    def compaction_threshold(self):
+        return self._compaction_threshold
+
+    @compaction_threshold.setter
+    def compaction_threshold(self, value):
+        self._compaction_threshold = value
+
+    @property
+    def sort_by_cell(self):
+        return self._sort_by_cell
+
+    @sort_by_cell.setter
+    def sort_by_cell(self, value):
+        self._sort_by_cell = value
+
+    @property
+    def small_cutoff(self):
+        return self._small_cutoff
+
+    @small_cutoff.setter
+    def small_cutoff(self, value):
+        if value < 0:
+            raise ValueError("Only non-negative small cutoffs permitted!")
+        self._small_cutoff = value
+
+    @property
+    def pair_list(self):
+        return self._pair_list
+
+    @pair_list.setter
+    def pair_list(self, value):
+        self._pair_list = value
+
+    @property
+    def sparse_cells(self):
+        return self._sparse_cells
+
+    @sparse_cells.setter
+    def sparse_cells(self, value):
+        self._sparse_cells = value
+
+    @property
+    def skin(self):
+        return self._skin
+
+    @skin.setter
+    def skin(self, value):
+        if value < 0:
+            raise ValueError("Only non-negative skins permitted!")
+        self._skin = value
+
+    @property
+    def auto_tune(self):
+        return self._auto_tune
+
+    @auto_tune.setter
+    def auto_tune(self, value):
+        self._auto_tune = value
+
+    @property
+    def auto_tune_steps(self):
+        return self._auto_tune_steps
+
+    @auto_tune_steps.setter
+    def auto_tune_steps(self, value):
+        if value <= 0:
+            raise ValueError("Only strictly positive numbers of auto tune steps permitted!")
+        self._auto_tune_steps = value
+
     def to_json(self):
         import json
         return json.dumps({"CPU": {
             "neighbor_list": {
                 "cll_radius": self.cell_linked_list_radius,
+                "verlet": self.verlet_list,
+                "hilbert_sort_interval": self.hilbert_sort_interval,
+                "hilbert_sort_threshold": self.hilbert_sort_threshold,
+                "compaction_threshold": self.compaction_threshold,
+                "sort_by_cell": self.sort_by_cell,
+                "small_cutoff": self.small_cutoff,
+                "pair_list": self.pair_list,
+                "sparse_cells": self.sparse_cells,
+                "skin": self.skin,
+                "auto_tune": self.auto_tune,
+                "auto_tune_steps": self.auto_tune_steps,
             },
             "thread_config": {
                 "n_threads": self.n_threads,
+            },
+            "particle_data": {
+                "index_ids": self.index_ids,
+                "id_block_size": self.id_block_size,
             }
         }
         })